@@ -4,9 +4,20 @@
 #ifndef _BURITTO_HPP_
 #define _BURITTO_HPP_
 
+#include <algorithm>
 #include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
+#include <ctime>
+#include <new>
 #include <type_traits>
+#include <utility>
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
 
 constexpr bool isPowerOfTwo(uint32_t v) {
     return v && ((v & (v - 1)) == 0);
@@ -27,20 +38,98 @@ typename std::enable_if<!isPowerOfTwo(Capacity), uint32_t>::type index(uint64_t
     return static_cast<uint32_t>(counter % Capacity);
 }
 
-template <class T, uint32_t Capacity>
+// the capacity of the BuRiTTO is set at construction and the ring and the data are placed in caller-provided memory
+constexpr uint32_t BURITTO_DYNAMIC_CAPACITY {0};
+
+// the ring and the data are arrays for a capacity which is known at compile time and pointers to caller-provided memory for a dynamic capacity
+template <typename T, uint32_t Size>
+struct BuRiTTOArray {
+    T& operator[](uint32_t i) { return elements[i]; }
+
+    T elements[Size];
+};
+
+template <typename T>
+struct BuRiTTOArray<T, BURITTO_DYNAMIC_CAPACITY> {
+    T& operator[](uint32_t i) { return elements[i]; }
+
+    T* elements {nullptr};
+};
+
+// The layout policies define how the members of the BuRiTTO which are owned by the push thread, owned by the pop thread or shared between both
+// threads are placed in memory; the packed layout places the members as close as possible at the cost of false sharing between the threads
+struct BuRiTTOPackedLayout {
+    template <typename T>
+    static constexpr std::size_t ALIGNMENT {alignof(T)};
+};
+
+// each group of members is placed on its own cache line which prevents false sharing between the push and the pop thread at the cost of memory
+struct BuRiTTOIsolatedLayout {
+    static constexpr std::size_t CACHE_LINE_SIZE {64};
+
+    template <typename T>
+    static constexpr std::size_t ALIGNMENT {alignof(T) > CACHE_LINE_SIZE ? alignof(T) : CACHE_LINE_SIZE};
+};
+
+// The statistics policies define whether the BuRiTTO counts its operations; the counters are placed with the members of the thread which
+// writes them, incremented with a load and a store instead of a read-modify-write and can be read by any thread with a relaxed load.
+// Without statistics the counters and their updates are compiled out.
+struct BuRiTTONoStatistics {
+    static constexpr bool ENABLED {false};
+};
+
+struct BuRiTTOOperationStatistics {
+    static constexpr bool ENABLED {true};
+};
+
+// the 'Blocking' parameter enables 'popWait'; push then has to check for a waiting pop thread with a fence, which is not paid by a BuRiTTO
+// without blocking pop
+template <class T, uint32_t Capacity, typename Layout = BuRiTTOPackedLayout, typename Statistics = BuRiTTONoStatistics, bool Blocking = false>
 class BuRiTTO { // Buffer Ring To Trustily Overrun ... well, at least for almost 585 years with 1 push per nanosecond ... then the universe implodes
 private:
-    // TODO use a second array with of uint64_t m_slots[static_cast<uint64_t>(Capacity) + 2];
-    //      m_data then holds all the data (>8 Byte and non trivialy copyable possible)
-    //      m_slots are the "pointer" to the actual data which are also in the Transaction::value
-    //      m_data will only be accessed once the ownership of the slot belongs to the thread
-    T m_data[Capacity];
+    // the data is not stored in the ring but in slots; the ring and the transactions contain only the indices of the slots, therefore an exchange
+    // does not depend on the size of T and T does not need to be copyable
+    // m_data is only accessed by the thread which owns the slot; besides the Capacity slots of the ring, each transaction and the push and
+    // pop thread own one slot
+    static constexpr uint32_t NumberOfSlots {Capacity == BURITTO_DYNAMIC_CAPACITY ? 0 : Capacity + 5};
+
+    // an entry of the ring consists of the lower 39 bit of the counter of the element, a free flag and a 24 bit slot index; the counter bits
+    // wrap after 2^39 pushes, therefore the CAS of the pop thread is prone to ABA if the pop thread is stalled for that many pushes between
+    // loading an entry and the CAS, which is more than 9 minutes with one push per nanosecond
+    static constexpr uint32_t SLOT_BITS {24};
+    static constexpr uint32_t COUNTER_SHIFT {SLOT_BITS + 1};
+    static constexpr uint64_t COUNTER_MASK {(1ULL << (64 - COUNTER_SHIFT)) - 1};
+    static_assert(NumberOfSlots < (1U << SLOT_BITS), "The slot index must fit into the lower 24 bit of a ring entry");
+
+    // placeholder for the optional members; each member has its own type to not require distinct addresses
+    template <uint32_t>
+    struct NoCounters {};
+
+    // only a dynamic capacity is stored, a capacity which is known at compile time is used as constant; the mask is used instead of the
+    // modulo for a power of two capacity
+    struct DynamicCapacity {
+        uint32_t capacity {0};
+        bool     isPowerOfTwo {false};
+    };
+    [[no_unique_address]] std::conditional_t<Capacity == BURITTO_DYNAMIC_CAPACITY, DynamicCapacity, NoCounters<3>> m_dynamicCapacity {};
+
+    BuRiTTOArray<T, NumberOfSlots> m_data;
+
+    // the pop thread claims an element by replacing the entry with its free slot and sets the free flag; the push thread publishes an element
+    // by replacing the entry with the slot it wrote the data to; the entry which is replaced by the push thread contains either a free slot or
+    // the overrun element
+    static constexpr uint64_t FREE {1ULL << SLOT_BITS};
+    static constexpr uint64_t SLOT_MASK {FREE - 1};
+    static constexpr uint32_t NO_SLOT {static_cast<uint32_t>(SLOT_MASK)};
+
+    alignas(Layout::template ALIGNMENT<std::atomic<uint64_t>>) BuRiTTOArray<std::atomic<uint64_t>, Capacity> m_slots;
 
     enum class TaSource { POP, PUSH };
 
     // transactions are used for read counter synchronization and overrun handling
-    struct Transaction {
-        T        value;
+    // the transactions are owned alternately by the push and the pop thread, therefore each one is aligned on its own
+    struct alignas(Layout::template ALIGNMENT<uint64_t>) Transaction {
+        uint32_t slot {0};
         uint64_t counter {0};
         TaSource source {TaSource::POP};
     };
@@ -50,68 +139,268 @@ private:
 
     // transactions idices for m_ta
     // pop is used in the pop thread, overrun in the push thread and pending to exchange transactions
-    uint8_t              m_taPop {0};
-    uint8_t              m_taOverrun {1};
-    std::atomic<uint8_t> m_taPending {2};
+    alignas(Layout::template ALIGNMENT<std::atomic<uint8_t>>) std::atomic<uint8_t> m_taPending {2};
+
+    // consecutive counter; in conjunction with Capacity this is used to calculate the access index to m_slots
+    // the write counter is only written by the push thread and the read counter only by the pop thread
+    alignas(Layout::template ALIGNMENT<std::atomic<uint64_t>>) std::atomic<uint64_t> m_writeCounter {0};
+    alignas(Layout::template ALIGNMENT<std::atomic<uint64_t>>) std::atomic<uint64_t> m_readCounterPop {0};
+
+    // the wake-up counter is used as futex for 'popWait'; the push thread only checks the number of waiters to skip the wake-up syscall;
+    // it only exists with blocking pop
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t) && std::atomic<uint32_t>::is_always_lock_free,
+                  "The wake-up counter is used as futex");
+    struct alignas(Layout::template ALIGNMENT<std::atomic<uint32_t>>) WaitState {
+        std::atomic<uint32_t> wakeUpCounter {0};
+        std::atomic<uint32_t> numberOfWaiters {0};
+    };
+    [[no_unique_address]] std::conditional_t<Blocking, WaitState, NoCounters<2>> m_waitState {};
+
+    struct PushCounters {
+        std::atomic<uint64_t> pushes {0};
+        std::atomic<uint64_t> overruns {0};
+    };
+
+    struct PopCounters {
+        std::atomic<uint64_t> pops {0};
+        std::atomic<uint64_t> transactionCorrections {0};
+    };
+
+    // members owned by the push thread; the free slot is used for the next element
+    alignas(Layout::template ALIGNMENT<uint64_t>) uint64_t m_readCounterPush {0};
+    uint32_t m_freeSlotPush {0};
+    uint8_t  m_taOverrun {1};
+    [[no_unique_address]] std::conditional_t<Statistics::ENABLED, PushCounters, NoCounters<0>> m_pushCounters {};
+
+    // members owned by the pop thread; the write counter is a local copy and the free slot is put into the ring when an element is claimed
+    alignas(Layout::template ALIGNMENT<uint64_t>) uint64_t m_writeCounterPop {0};
+    uint32_t m_freeSlotPop {0};
+    uint8_t  m_taPop {0};
+    [[no_unique_address]] std::conditional_t<Statistics::ENABLED, PopCounters, NoCounters<1>> m_popCounters {};
+
+    static uint64_t entry(uint64_t counter, uint32_t slot) { return (counter << COUNTER_SHIFT) | slot; }
+    static uint32_t slotOf(uint64_t entry) { return static_cast<uint32_t>(entry & SLOT_MASK); }
+    static bool     isElement(uint64_t entry, uint64_t counter) { return !(entry & FREE) && (entry >> COUNTER_SHIFT) == (counter & COUNTER_MASK); }
+
+    uint32_t capacity() const {
+        if constexpr (Capacity == BURITTO_DYNAMIC_CAPACITY) {
+            return m_dynamicCapacity.capacity;
+        } else {
+            return Capacity;
+        }
+    }
 
-    // consecutive counter; in conjunction with Capacity this is used to calculate the access index to m_data
-    std::atomic<uint64_t> m_writeCounter {0};
-    std::atomic<uint64_t> m_readCounterPop {0};
-    uint64_t              m_readCounterPush {0};
+    uint32_t indexOf(uint64_t counter) const {
+        if constexpr (Capacity == BURITTO_DYNAMIC_CAPACITY) {
+            return m_dynamicCapacity.isPowerOfTwo ? static_cast<uint32_t>(counter & mask(m_dynamicCapacity.capacity))
+                                                  : static_cast<uint32_t>(counter % m_dynamicCapacity.capacity);
+        } else {
+            return index<Capacity>(counter);
+        }
+    }
+
+    static uint64_t dataOffset(uint32_t capacity) {
+        return (capacity * sizeof(std::atomic<uint64_t>) + alignof(T) - 1) / alignof(T) * alignof(T);
+    }
+
+    void init() {
+        for (uint32_t i = 0; i < capacity(); i++) {
+            m_slots[i].store(entry(0, i) | FREE, std::memory_order_relaxed);
+        }
+        m_freeSlotPush = capacity();
+        m_freeSlotPop  = capacity() + 1;
+        for (uint32_t i = 0; i < 3; i++) {
+            m_ta[i].slot = capacity() + 2 + i;
+        }
+    }
 
 public:
-    BuRiTTO()  = default;
-    ~BuRiTTO() = default;
+    template <uint32_t C = Capacity, typename std::enable_if<C != BURITTO_DYNAMIC_CAPACITY, int>::type = 0>
+    BuRiTTO() {
+        init();
+    }
+
+    // the capacity is set at construction and the ring and the data are placed in the 'memory', which must have 'requiredMemorySize' bytes
+    // with an alignment of 'memoryAlignment' and must outlive the BuRiTTO; the memory can come from an allocator or a raw memory region
+    template <uint32_t C = Capacity, typename std::enable_if<C == BURITTO_DYNAMIC_CAPACITY, int>::type = 0>
+    BuRiTTO(uint32_t capacity, void* memory)
+        : m_dynamicCapacity {capacity, isPowerOfTwo(capacity)} {
+        assert(capacity > 0 && capacity + 5 < (1U << SLOT_BITS) && "Capacity out of range");
+        assert(reinterpret_cast<uintptr_t>(memory) % memoryAlignment() == 0 && "Memory is not aligned");
+
+        m_slots.elements = static_cast<std::atomic<uint64_t>*>(memory);
+        m_data.elements  = reinterpret_cast<T*>(static_cast<uint8_t*>(memory) + dataOffset(capacity));
+        for (uint32_t i = 0; i < capacity; i++) {
+            new (&m_slots[i]) std::atomic<uint64_t>;
+        }
+        for (uint32_t i = 0; i < capacity + 5; i++) {
+            new (&m_data[i]) T;
+        }
+        init();
+    }
+
+    ~BuRiTTO() {
+        if constexpr (Capacity == BURITTO_DYNAMIC_CAPACITY) {
+            for (uint32_t i = 0; i < capacity() + 5; i++) {
+                m_data[i].~T();
+            }
+        }
+    }
+
+    static uint64_t requiredMemorySize(uint32_t capacity) {
+        static_assert(Capacity == BURITTO_DYNAMIC_CAPACITY, "Only a BuRiTTO with a dynamic capacity uses caller-provided memory");
+        return dataOffset(capacity) + (capacity + 5ULL) * sizeof(T);
+    }
+
+    static constexpr uint64_t memoryAlignment() {
+        static_assert(Capacity == BURITTO_DYNAMIC_CAPACITY, "Only a BuRiTTO with a dynamic capacity uses caller-provided memory");
+        return alignof(T) > alignof(std::atomic<uint64_t>) ? alignof(T) : alignof(std::atomic<uint64_t>);
+    }
+
+    BuRiTTO(const BuRiTTO&) = delete;
+    BuRiTTO(BuRiTTO&&)      = delete;
+
+    BuRiTTO& operator=(const BuRiTTO&) = delete;
+    BuRiTTO& operator=(BuRiTTO&&)      = delete;
+
+    // snapshot of the operation counters; the counters are loaded one after another while the push and the pop thread continue, therefore
+    // they are not consistent to each other
+    struct Counters {
+        uint64_t pushes {0};
+        uint64_t overruns {0};
+        uint64_t pops {0};
+        // the pops which took the oldest element from the transaction since the push thread overran the element at the read counter
+        uint64_t transactionCorrections {0};
+    };
 
-    bool push(const T inValue, T& outValue) {
-        uint64_t readCounter  = m_readCounterPush;
+    // can be called from any thread, e.g. a monitoring thread
+    Counters counters() const {
+        static_assert(Statistics::ENABLED, "The counters are only available with 'BuRiTTOOperationStatistics'");
+        Counters snapshot;
+        snapshot.pushes                 = m_pushCounters.pushes.load(std::memory_order_relaxed);
+        snapshot.overruns               = m_pushCounters.overruns.load(std::memory_order_relaxed);
+        snapshot.pops                   = m_popCounters.pops.load(std::memory_order_relaxed);
+        snapshot.transactionCorrections = m_popCounters.transactionCorrections.load(std::memory_order_relaxed);
+        return snapshot;
+    }
+
+    bool push(T inValue, T& outValue) {
         uint64_t writeCounter = m_writeCounter.load(std::memory_order_relaxed);
         bool     overrun      = false;
 
-        if (writeCounter - readCounter >= Capacity) { // overrun might happen
-            uint64_t oldPendingCounter = m_ta[m_taOverrun].counter;
-            m_ta[m_taOverrun].source   = TaSource::PUSH;
-            m_ta[m_taOverrun].value    = m_data[index<Capacity>(readCounter)];
-            readCounter++;
-            m_ta[m_taOverrun].counter = readCounter;
-            m_taOverrun               = m_taPending.exchange(m_taOverrun, std::memory_order_acq_rel);
-
-            if (m_ta[m_taOverrun].source == TaSource::PUSH && m_ta[m_taOverrun].counter > oldPendingCounter) { // overrun happend
+        uint32_t overrunSlot = store(writeCounter, std::move(inValue), std::memory_order_release);
+        if (overrunSlot != NO_SLOT) {
+            keep(overrunSlot);
+            uint32_t returnedSlot = park(writeCounter - capacity() + 1);
+            if (returnedSlot != NO_SLOT) { // overrun happend
                 overrun  = true;
-                outValue = m_ta[m_taOverrun].value;
-            } else if (m_ta[m_taOverrun].counter > readCounter) {
-                readCounter = m_ta[m_taOverrun].counter;
+                outValue = std::move(m_data[returnedSlot]);
             }
-            m_readCounterPush = readCounter;
         }
 
-        m_data[index<Capacity>(writeCounter)] = inValue;
         m_writeCounter.store(++writeCounter, std::memory_order_release);
+        notify();
+        countPushes(1, overrun ? 1 : 0);
 
         return !overrun;
     }
 
+    // pushes 'count' values and publishes them with a single store of the write counter; only the newest overrun element is parked with one
+    // transaction exchange, the other overrun values are moved to 'outValues' in the order of the pushes; 'outValues' must have space for
+    // 'count' values; returns the number of overrun values
+    uint32_t pushBatch(T* inValues, uint32_t count, T* outValues) {
+        uint64_t writeCounter = m_writeCounter.load(std::memory_order_relaxed);
+        uint32_t numberOfOverruns {0};
+        uint64_t parkCounter {0};
+
+        for (uint32_t i = 0; i < count; i++, writeCounter++) {
+            // the entries become visible to the pop thread with the write counter, therefore they don't need a release store
+            uint32_t overrunSlot = store(writeCounter, std::move(inValues[i]), std::memory_order_relaxed);
+            if (overrunSlot != NO_SLOT) {
+                // the push thread owns the previously kept element since it was not yet parked
+                if (parkCounter != 0) { outValues[numberOfOverruns++] = std::move(m_data[m_ta[m_taOverrun].slot]); }
+                keep(overrunSlot);
+                parkCounter = writeCounter - capacity() + 1;
+            }
+        }
+
+        if (parkCounter != 0) {
+            uint32_t returnedSlot = park(parkCounter);
+            if (returnedSlot != NO_SLOT) {
+                // the previously parked element is older than the ones overrun by this batch
+                outValues[numberOfOverruns++] = std::move(m_data[returnedSlot]);
+                std::rotate(outValues, outValues + numberOfOverruns - 1, outValues + numberOfOverruns);
+            }
+        }
+
+        m_writeCounter.store(writeCounter, std::memory_order_release);
+        notify();
+        countPushes(count, numberOfOverruns);
+
+        return numberOfOverruns;
+    }
+
     bool pop(T& outValue) {
-        uint64_t readCounter  = m_readCounterPop.load(std::memory_order_relaxed);
-        uint64_t writeCounter = m_writeCounter.load(std::memory_order_acquire);
+        uint64_t readCounter = m_readCounterPop.load(std::memory_order_relaxed);
 
-        if (readCounter == writeCounter) { return false; }
+        if (!available(readCounter)) { return false; }
 
-        outValue             = m_data[index<Capacity>(readCounter)];
-        m_ta[m_taPop].source = TaSource::POP;
-        readCounter++;
-        m_ta[m_taPop].counter = readCounter;
-        m_taPop               = m_taPending.exchange(m_taPop, std::memory_order_acq_rel);
+        bool corrected = take(readCounter, outValue);
+
+        m_readCounterPop.store(readCounter, std::memory_order_release);
+        countPops(1, corrected ? 1 : 0);
+
+        return true;
+    }
+
+    // pops up to 'maxCount' values to 'outValues' with a single store of the read counter; the transaction is only exchanged when the push
+    // thread overran an element; returns the number of popped values, which is only less than 'maxCount' if the BuRiTTO became empty
+    uint32_t popBatch(T* outValues, uint32_t maxCount) {
+        uint64_t readCounter = m_readCounterPop.load(std::memory_order_relaxed);
+        uint32_t numberOfValues {0};
+        uint32_t numberOfCorrections {0};
 
-        // pendig overrun ... needs to be >= because the push thread might already have overwritten the value in m_data we stored in outValue
-        if (m_ta[m_taPop].counter >= readCounter) {
-            outValue    = m_ta[m_taPop].value;
-            readCounter = m_ta[m_taPop].counter;
+        while (numberOfValues < maxCount && available(readCounter)) {
+            if (take(readCounter, outValues[numberOfValues])) { numberOfCorrections++; }
+            numberOfValues++;
         }
 
-        m_readCounterPop.store(readCounter, std::memory_order_relaxed);
+        if (numberOfValues > 0) { m_readCounterPop.store(readCounter, std::memory_order_release); }
+        countPops(numberOfValues, numberOfCorrections);
 
-        return true;
+        return numberOfValues;
+    }
+
+    // like 'pop' but waits up to 'timeout' for a value; the BuRiTTO is polled for a short while before the pop thread goes to sleep and the
+    // push thread only wakes it up when it is waiting
+    bool popWait(T& outValue, std::chrono::nanoseconds timeout) {
+        static_assert(Blocking, "The blocking pop is only available with 'Blocking' enabled");
+
+        for (uint32_t i = 0; i < WAIT_SPIN_COUNT; i++) {
+            if (pop(outValue)) { return true; }
+        }
+
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (true) {
+            auto remainingTime = deadline - std::chrono::steady_clock::now();
+            if (remainingTime <= std::chrono::nanoseconds::zero()) { return false; }
+
+            // the wake-up counter is loaded before the write counter is checked again, therefore a push after the check changes the counter
+            // and the futex does not sleep; the fence pairs with the fence in 'notify' and ensures that either the pop thread sees the new
+            // write counter or the push thread sees the waiter
+            uint32_t wakeUpCounter = m_waitState.wakeUpCounter.load(std::memory_order_acquire);
+            m_waitState.numberOfWaiters.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            bool popped = pop(outValue);
+            if (!popped) {
+                futexWait(wakeUpCounter, std::chrono::duration_cast<std::chrono::nanoseconds>(remainingTime));
+                popped = pop(outValue);
+            }
+
+            m_waitState.numberOfWaiters.fetch_sub(1, std::memory_order_relaxed);
+            if (popped) { return true; }
+        }
     }
 
     bool empty() {
@@ -119,6 +408,146 @@ public:
         // not empty
         return m_readCounterPop.load(std::memory_order_relaxed) == m_writeCounter.load(std::memory_order_relaxed);
     }
+
+private:
+    // the counters are only written by one thread, therefore a load and store is sufficient
+    static void increment(std::atomic<uint64_t>& counter, uint64_t value) {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    void countPushes(uint64_t pushes, uint64_t overruns) {
+        if constexpr (Statistics::ENABLED) {
+            increment(m_pushCounters.pushes, pushes);
+            if (overruns > 0) { increment(m_pushCounters.overruns, overruns); }
+        }
+    }
+
+    void countPops(uint64_t pops, uint64_t transactionCorrections) {
+        if constexpr (Statistics::ENABLED) {
+            if (pops > 0) { increment(m_popCounters.pops, pops); }
+            if (transactionCorrections > 0) { increment(m_popCounters.transactionCorrections, transactionCorrections); }
+        }
+    }
+
+    // the number of 'pop' attempts before the pop thread goes to sleep
+    static constexpr uint32_t WAIT_SPIN_COUNT {100};
+
+    // wakes up the pop thread if it is waiting; the syscall is only done when the pop thread registered as waiter and without blocking pop
+    // nothing is done at all
+    void notify() {
+        if constexpr (Blocking) {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (m_waitState.numberOfWaiters.load(std::memory_order_relaxed) == 0) { return; }
+
+            m_waitState.wakeUpCounter.fetch_add(1, std::memory_order_release);
+            syscall(SYS_futex, reinterpret_cast<uint32_t*>(&m_waitState.wakeUpCounter), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+        }
+    }
+
+    void futexWait(uint32_t expected, std::chrono::nanoseconds timeout) {
+        auto seconds  = std::chrono::duration_cast<std::chrono::seconds>(timeout);
+        auto timeSpec = timespec {static_cast<time_t>(seconds.count()), static_cast<long>((timeout - seconds).count())};
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&m_waitState.wakeUpCounter), FUTEX_WAIT_PRIVATE, expected, &timeSpec, nullptr, 0);
+    }
+
+    // writes the value to the free slot and publishes the slot at the entry of the write counter; returns the slot of the overrun element
+    // if the pop thread did not yet claim the replaced one, the push thread then needs a new free slot
+    uint32_t store(uint64_t writeCounter, T&& value, std::memory_order order) {
+        auto& ringEntry = m_slots[indexOf(writeCounter)];
+
+        m_data[m_freeSlotPush] = std::move(value);
+
+        // the pop thread stores its read counter after it claimed an element, therefore it is only loaded when the local copy is outdated
+        if (writeCounter - m_readCounterPush >= capacity()) { m_readCounterPush = m_readCounterPop.load(std::memory_order_acquire); }
+
+        if (writeCounter - m_readCounterPush < capacity()) {
+            // the pop thread already claimed the element at this entry and left a free slot
+            uint32_t freeSlot = slotOf(ringEntry.load(std::memory_order_relaxed));
+            ringEntry.store(entry(writeCounter, m_freeSlotPush), order);
+            m_freeSlotPush = freeSlot;
+            return NO_SLOT;
+        }
+
+        // overrun might happen
+        uint64_t replacedEntry = ringEntry.exchange(entry(writeCounter, m_freeSlotPush), std::memory_order_acq_rel);
+        if (replacedEntry & FREE) {
+            m_freeSlotPush = slotOf(replacedEntry);
+            return NO_SLOT;
+        }
+
+        m_readCounterPush = writeCounter - capacity() + 1;
+        return slotOf(replacedEntry);
+    }
+
+    // the push thread owns the overrun element and keeps it in its transaction; the free slot of the transaction is used for the next push
+    void keep(uint32_t overrunSlot) {
+        m_freeSlotPush         = m_ta[m_taOverrun].slot;
+        m_ta[m_taOverrun].slot = overrunSlot;
+    }
+
+    // exchanges the transaction with the kept element with the pending one; returns the slot of the previously parked element if the pop
+    // thread did not take it
+    uint32_t park(uint64_t readCounter) {
+        uint64_t oldPendingCounter = m_ta[m_taOverrun].counter;
+        m_ta[m_taOverrun].source   = TaSource::PUSH;
+        m_ta[m_taOverrun].counter  = readCounter;
+        m_taOverrun                = m_taPending.exchange(m_taOverrun, std::memory_order_acq_rel);
+
+        if (m_ta[m_taOverrun].source == TaSource::PUSH && m_ta[m_taOverrun].counter > oldPendingCounter) { return m_ta[m_taOverrun].slot; }
+
+        if (m_ta[m_taOverrun].counter > m_readCounterPush) { m_readCounterPush = m_ta[m_taOverrun].counter; }
+        return NO_SLOT;
+    }
+
+    // the push thread stores its write counter after it published an element, therefore it is only loaded when the local copy indicates an
+    // empty BuRiTTO; the elements below the local copy were published before the load and a parked element is synchronized by the exchange
+    // of the transaction, therefore it is sufficient to acquire the write counter only on reload
+    bool available(uint64_t readCounter) {
+        if (readCounter < m_writeCounterPop) { return true; }
+        m_writeCounterPop = m_writeCounter.load(std::memory_order_acquire);
+        return readCounter < m_writeCounterPop;
+    }
+
+    // claims the element with the read counter by replacing the entry with the free slot of the pop thread
+    bool claim(uint64_t readCounter, T& outValue) {
+        auto&    ringEntry    = m_slots[indexOf(readCounter)];
+        uint64_t currentEntry = ringEntry.load(std::memory_order_acquire);
+        if (!isElement(currentEntry, readCounter)) { return false; }
+        if (!ringEntry.compare_exchange_strong(currentEntry, entry(readCounter, m_freeSlotPop) | FREE, std::memory_order_acq_rel,
+                                               std::memory_order_relaxed)) {
+            return false;
+        }
+
+        m_freeSlotPop = slotOf(currentEntry);
+        outValue      = std::move(m_data[m_freeSlotPop]);
+        return true;
+    }
+
+    // takes the element at the read counter, which is available; if the claim fails, the push thread overran the element and parks the oldest
+    // element in the same push, therefore claim and transaction exchange are retried until the parked element shows up; the pop thread only
+    // spins while the push thread is between the overrun and the park; returns true if the element was taken from the transaction
+    bool take(uint64_t& readCounter, T& outValue) {
+        while (true) {
+            if (claim(readCounter, outValue)) {
+                readCounter++;
+                return false;
+            }
+            if (takeParked(readCounter, outValue)) { return true; }
+        }
+    }
+
+    // the push thread overran the element; the pending transaction contains the oldest element unless the push thread did not yet park it
+    bool takeParked(uint64_t& readCounter, T& outValue) {
+        m_ta[m_taPop].source  = TaSource::POP;
+        m_ta[m_taPop].counter = readCounter;
+        m_taPop               = m_taPending.exchange(m_taPop, std::memory_order_acq_rel);
+
+        if (m_ta[m_taPop].source != TaSource::PUSH || m_ta[m_taPop].counter <= readCounter) { return false; }
+
+        outValue    = std::move(m_data[m_ta[m_taPop].slot]);
+        readCounter = m_ta[m_taPop].counter;
+        return true;
+    }
 };
 
 #endif // _BURITTO_HPP_
@@ -0,0 +1,259 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// SPDX-FileCopyrightText: © 2023 Mathias Kraus <elboberido@m-hias.de>
+
+#ifndef _COROUTINE_EXECUTOR_HPP_
+#define _COROUTINE_EXECUTOR_HPP_
+
+#if __cplusplus < 202002L
+#error "The coroutine executor requires C++20"
+#endif
+
+#include <atomic>
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+// Coroutine support for the queues
+//
+// An 'AsyncConsumer' wraps the pop operation of a queue, e.g. of a RoQueT consumer or a BuRiTTO, and 'co_await consumer.next()' suspends
+// the coroutine until data arrives. The 'Executor' runs the coroutines on a single thread and resumes them when the producers publish data.
+// The producer calls 'notify' of the 'AsyncConsumer' after each push. Like with the 'EventNotifier', the consumer arms a flag when it
+// suspends and the producer only schedules the consumer when it takes the armed flag, therefore a push to a queue without a suspended
+// consumer costs only a fence and a load. The scheduled consumers are pushed to a lock-free list of the 'Executor' and only the push to
+// the empty list writes to the eventfd of the 'Executor'.
+
+class Executor;
+
+// fire-and-forget coroutine which is run by the 'Executor'
+class Task {
+public:
+    struct promise_type {
+        Task                get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void                return_void() {}
+        void                unhandled_exception() { std::terminate(); }
+    };
+
+    Task(const Task&) = delete;
+    Task(Task&& rhs) noexcept
+        : handle(std::exchange(rhs.handle, nullptr)) {}
+
+    Task& operator=(const Task&) = delete;
+    Task& operator=(Task&&)      = delete;
+
+    ~Task() {
+        if (handle) { handle.destroy(); }
+    }
+
+    friend class Executor;
+
+private:
+    explicit Task(std::coroutine_handle<promise_type> h)
+        : handle(h) {}
+
+private:
+    std::coroutine_handle<promise_type> handle;
+};
+
+// a consumer which can be scheduled by a producer; only used by the 'AsyncConsumer'
+class AsyncWaiter {
+public:
+    AsyncWaiter(const AsyncWaiter&) = delete;
+    AsyncWaiter(AsyncWaiter&&)      = delete;
+
+    AsyncWaiter& operator=(const AsyncWaiter&) = delete;
+    AsyncWaiter& operator=(AsyncWaiter&&)      = delete;
+
+    friend class Executor;
+
+protected:
+    AsyncWaiter()  = default;
+    ~AsyncWaiter() = default;
+
+    // called by the 'Executor' when the waiter was scheduled
+    virtual void wake() = 0;
+
+protected:
+    AsyncWaiter* nextScheduled {nullptr};
+};
+
+class Executor {
+public:
+    Executor()
+        : eventFd(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) {}
+
+    Executor(const Executor&) = delete;
+    Executor(Executor&&)      = delete;
+
+    Executor& operator=(const Executor&) = delete;
+    Executor& operator=(Executor&&)      = delete;
+
+    ~Executor() {
+        for (auto handle : tasks) {
+            handle.destroy();
+        }
+        if (eventFd != -1) { close(eventFd); }
+    }
+
+    // the task is started by 'run'
+    void spawn(Task task) { tasks.push_back(std::exchange(task.handle, nullptr)); }
+
+    // the pollable file descriptor; it becomes readable when a consumer was scheduled
+    int fd() const { return eventFd; }
+
+    // runs the tasks until all of them are finished; blocks on the eventfd when no consumer is scheduled
+    void run() {
+        for (auto handle : tasks) {
+            handle.resume();
+        }
+        removeFinishedTasks();
+
+        while (!tasks.empty()) {
+            if (!run_scheduled()) {
+                pollfd pollFd {eventFd, POLLIN, 0};
+                poll(&pollFd, 1, -1);
+                uint64_t              value {0};
+                [[maybe_unused]] auto result = read(eventFd, &value, sizeof(value));
+            }
+            removeFinishedTasks();
+        }
+    }
+
+    // wakes the scheduled consumers in the order they were scheduled; returns false if no consumer was scheduled
+    bool run_scheduled() {
+        AsyncWaiter* waiter = scheduledWaiters.exchange(nullptr, std::memory_order_acquire);
+        if (waiter == nullptr) { return false; }
+
+        AsyncWaiter* reversed {nullptr};
+        while (waiter != nullptr) {
+            auto next             = waiter->nextScheduled;
+            waiter->nextScheduled = reversed;
+            reversed              = waiter;
+            waiter                = next;
+        }
+        while (reversed != nullptr) {
+            auto next = reversed->nextScheduled;
+            reversed->wake();
+            reversed = next;
+        }
+        return true;
+    }
+
+    // called by the producer thread; a waiter is only scheduled once until it is woken up, therefore it is safe to push it to the list
+    void schedule(AsyncWaiter& waiter) {
+        auto head = scheduledWaiters.load(std::memory_order_relaxed);
+        do {
+            waiter.nextScheduled = head;
+        } while (!scheduledWaiters.compare_exchange_weak(head, &waiter, std::memory_order_release, std::memory_order_relaxed));
+
+        if (head == nullptr) {
+            uint64_t              value {1};
+            [[maybe_unused]] auto result = write(eventFd, &value, sizeof(value));
+        }
+    }
+
+private:
+    void removeFinishedTasks() {
+        for (auto it = tasks.begin(); it != tasks.end();) {
+            if (it->done()) {
+                it->destroy();
+                it = tasks.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+private:
+    int                                                    eventFd {-1};
+    std::atomic<AsyncWaiter*>                              scheduledWaiters {nullptr};
+    std::vector<std::coroutine_handle<Task::promise_type>> tasks;
+};
+
+// wraps the 'pop' of a queue, which returns an optional with the data; the 'next' and 'wake' operations are done on the thread of the
+// 'Executor' while 'notify' is called by the producer
+template <typename Pop>
+class AsyncConsumer : public AsyncWaiter {
+public:
+    using T = typename std::invoke_result_t<Pop&>::value_type;
+
+    AsyncConsumer(Executor& e, Pop p)
+        : executor(e)
+        , pop(std::move(p)) {}
+
+    class Awaiter {
+    public:
+        bool await_ready() {
+            consumer.data = consumer.pop();
+            return consumer.data.has_value();
+        }
+
+        bool await_suspend(std::coroutine_handle<> handle) {
+            consumer.waiting = handle;
+            return consumer.arm();
+        }
+
+        T await_resume() {
+            T data = std::move(*consumer.data);
+            consumer.data.reset();
+            return data;
+        }
+
+        friend class AsyncConsumer;
+
+    private:
+        explicit Awaiter(AsyncConsumer& c)
+            : consumer(c) {}
+
+    private:
+        AsyncConsumer& consumer;
+    };
+
+    // suspends the coroutine until data is available; only one coroutine must wait on an 'AsyncConsumer'
+    Awaiter next() { return Awaiter(*this); }
+
+    // called by the producer after the data is pushed; the fence pairs with the fence in 'arm' and ensures that either the consumer sees the
+    // new data or the producer sees the armed flag
+    void notify() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (armed.load(std::memory_order_relaxed) == 0) { return; }
+        // the acquire pairs with the release store in 'arm' and ensures the link of the previous schedule is no longer used by the 'Executor'
+        if (armed.exchange(0, std::memory_order_acquire) == 0) { return; }
+        executor.schedule(*this);
+    }
+
+private:
+    // arms the flag and checks the queue again; returns true if the coroutine stays suspended; if the producer already took the armed flag,
+    // the consumer is scheduled and must not be resumed before it is woken up
+    bool arm() {
+        armed.store(1, std::memory_order_release);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        data = pop();
+        if (!data.has_value()) { return true; }
+        return armed.exchange(0, std::memory_order_relaxed) == 0;
+    }
+
+    void wake() override {
+        if (!data.has_value()) { data = pop(); }
+        if (data.has_value() || !arm()) { waiting.resume(); }
+    }
+
+private:
+    Executor&               executor;
+    Pop                     pop;
+    std::optional<T>        data;
+    std::coroutine_handle<> waiting;
+    std::atomic<uint32_t>   armed {0};
+};
+
+#endif // _COROUTINE_EXECUTOR_HPP_
@@ -0,0 +1,233 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// SPDX-FileCopyrightText: © 2023 Mathias Kraus <elboberido@m-hias.de>
+
+#ifndef _EVENT_NOTIFIER_HPP_
+#define _EVENT_NOTIFIER_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// Notification of a consumer in an event loop via an eventfd
+//
+// The notifier is not bound to a specific queue and can be used with a RoQueT as well as with a BuRiTTO. The 'State' is shared between the
+// producer and the consumer and is placed alongside the queue, e.g. in the header of a SharedRoQueT. The eventfd is created by the consumer
+// and registered in the 'State'; a producer in the same process obtains a duplicate of it with 'open'. A producer in another process obtains
+// it with 'receive' from a connected Unix domain socket to which the consumer passed it with 'share', which requires no further permissions.
+// The producer has to call 'notify' after each push or commit, otherwise the consumer misses the transition to non-empty and sleeps with
+// data in the queue. The 'NotifyingProducer' binds a producer to the notifier and takes care of this.
+// The consumer arms the notifier when it drained the queue and the producer only writes to the eventfd when the notifier is armed, therefore
+// the producer signals are coalesced to at most one write per transition from empty to non-empty. The consumer loop looks like this
+//   - wait until 'fd' becomes readable and call 'acknowledge'
+//   - pop until the queue is empty
+//   - 'arm' the notifier and check the queue again; if it is not empty, continue to pop
+class EventNotifier {
+public:
+    static_assert(std::atomic<uint32_t>::is_always_lock_free && std::atomic<int32_t>::is_always_lock_free,
+                  "The state must be lock-free to be shared between processes");
+
+    struct State {
+        std::atomic<uint32_t> armed {0};
+        std::atomic<int32_t>  pid {0};
+        std::atomic<int32_t>  eventFd {-1};
+    };
+
+    // creates the eventfd and registers it in the 'state'; this is done by the consumer
+    static std::optional<EventNotifier> create(State& state) {
+        std::optional<EventNotifier> notifier;
+
+        auto eventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (eventFd == -1) { return notifier; }
+
+        state.armed.store(0, std::memory_order_relaxed);
+        state.pid.store(getpid(), std::memory_order_relaxed);
+        state.eventFd.store(eventFd, std::memory_order_release);
+
+        notifier.emplace(EventNotifier(state, eventFd));
+        return notifier;
+    }
+
+    // obtains a duplicate of the eventfd registered in the 'state'; this is done by a producer in the same process as the consumer; returns a
+    // nullopt if the eventfd was registered by another process, in which case it has to be obtained with 'receive'
+    static std::optional<EventNotifier> open(State& state) {
+        std::optional<EventNotifier> notifier;
+
+        auto registeredFd = state.eventFd.load(std::memory_order_acquire);
+        if (registeredFd == -1 || state.pid.load(std::memory_order_relaxed) != getpid()) { return notifier; }
+
+        auto eventFd = fcntl(registeredFd, F_DUPFD_CLOEXEC, 0);
+        if (eventFd == -1) { return notifier; }
+
+        notifier.emplace(EventNotifier(state, eventFd));
+        return notifier;
+    }
+
+    // obtains the eventfd which the consumer passed with 'share' to the connected Unix domain 'socket'; this is done by a producer in another
+    // process than the consumer
+    static std::optional<EventNotifier> receive(State& state, int socket) {
+        std::optional<EventNotifier> notifier;
+
+        char  payload {0};
+        iovec payloadVector {&payload, sizeof(payload)};
+        alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))];
+
+        msghdr message {};
+        message.msg_iov        = &payloadVector;
+        message.msg_iovlen     = 1;
+        message.msg_control    = control;
+        message.msg_controllen = sizeof(control);
+        if (recvmsg(socket, &message, MSG_CMSG_CLOEXEC) != sizeof(payload)) { return notifier; }
+
+        auto controlMessage = CMSG_FIRSTHDR(&message);
+        if (controlMessage == nullptr || controlMessage->cmsg_level != SOL_SOCKET || controlMessage->cmsg_type != SCM_RIGHTS
+            || controlMessage->cmsg_len != CMSG_LEN(sizeof(int))) {
+            return notifier;
+        }
+
+        int eventFd {-1};
+        std::memcpy(&eventFd, CMSG_DATA(controlMessage), sizeof(eventFd));
+
+        notifier.emplace(EventNotifier(state, eventFd));
+        return notifier;
+    }
+
+    // passes the eventfd to a producer in another process via the connected Unix domain 'socket'; this is done by the consumer
+    bool share(int socket) const {
+        char  payload {0};
+        iovec payloadVector {&payload, sizeof(payload)};
+        alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))] {};
+
+        msghdr message {};
+        message.msg_iov        = &payloadVector;
+        message.msg_iovlen     = 1;
+        message.msg_control    = control;
+        message.msg_controllen = sizeof(control);
+
+        auto controlMessage        = CMSG_FIRSTHDR(&message);
+        controlMessage->cmsg_level = SOL_SOCKET;
+        controlMessage->cmsg_type  = SCM_RIGHTS;
+        controlMessage->cmsg_len   = CMSG_LEN(sizeof(int));
+        std::memcpy(CMSG_DATA(controlMessage), &eventFd, sizeof(eventFd));
+
+        return sendmsg(socket, &message, MSG_NOSIGNAL) == sizeof(payload);
+    }
+
+    EventNotifier(const EventNotifier&) = delete;
+    EventNotifier(EventNotifier&& rhs) noexcept
+        : state(rhs.state)
+        , eventFd(std::exchange(rhs.eventFd, -1)) {}
+
+    EventNotifier& operator=(const EventNotifier&) = delete;
+    EventNotifier& operator=(EventNotifier&&)      = delete;
+
+    ~EventNotifier() {
+        if (eventFd != -1) { close(eventFd); }
+    }
+
+    // the pollable file descriptor; it becomes readable when the producer signals the consumer
+    int fd() const { return eventFd; }
+
+    // called by the producer after the data is pushed; the fence pairs with the fence in 'arm' and ensures that either the consumer sees the
+    // new data or the producer sees the armed notifier
+    void notify() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (state.armed.load(std::memory_order_relaxed) == 0) { return; }
+        if (state.armed.exchange(0, std::memory_order_relaxed) == 0) { return; }
+
+        uint64_t              value {1};
+        [[maybe_unused]] auto result = write(eventFd, &value, sizeof(value));
+    }
+
+    // called by the consumer when the queue is empty; the queue has to be checked again afterwards since the producer might have pushed data
+    // before the notifier was armed
+    void arm() {
+        state.armed.store(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+    // called by the consumer when the file descriptor became readable; resets the eventfd
+    void acknowledge() {
+        uint64_t              value {0};
+        [[maybe_unused]] auto result = read(eventFd, &value, sizeof(value));
+    }
+
+private:
+    EventNotifier(State& s, int fd)
+        : state(s)
+        , eventFd(fd) {}
+
+private:
+    State& state;
+    int    eventFd {-1};
+};
+
+// Binds a producer to an 'EventNotifier' and notifies after each push or commit
+//
+// The 'Producer' is the producer of a RoQueT or TransactionalRoQueT or the BuRiTTO itself; the calls are forwarded unchanged. Each call
+// which publishes data has a notifying counterpart, including the camelCase 'pushBatch' of the BuRiTTO.
+template <typename Producer>
+class NotifyingProducer {
+public:
+    NotifyingProducer(Producer& p, EventNotifier& n)
+        : producer(p)
+        , notifier(n) {}
+
+    template <typename... Args>
+    decltype(auto) push(Args&&... args) {
+        decltype(auto) result = producer.push(std::forward<Args>(args)...);
+        notifier.notify();
+        return result;
+    }
+
+    template <typename... Args>
+    decltype(auto) push_checked(Args&&... args) {
+        decltype(auto) result = producer.push_checked(std::forward<Args>(args)...);
+        notifier.notify();
+        return result;
+    }
+
+    template <typename... Args>
+    decltype(auto) push_cancellable(Args&&... args) {
+        decltype(auto) result = producer.push_cancellable(std::forward<Args>(args)...);
+        notifier.notify();
+        return result;
+    }
+
+    template <typename... Args>
+    decltype(auto) pushBatch(Args&&... args) {
+        decltype(auto) result = producer.pushBatch(std::forward<Args>(args)...);
+        notifier.notify();
+        return result;
+    }
+
+    template <typename... Args>
+    decltype(auto) push_batch(Args&&... args) {
+        decltype(auto) result = producer.push_batch(std::forward<Args>(args)...);
+        notifier.notify();
+        return result;
+    }
+
+    template <typename... Args>
+    void commit(Args&&... args) {
+        producer.commit(std::forward<Args>(args)...);
+        notifier.notify();
+    }
+
+    // access to the operations which do not publish data, like 'loan', 'cancel' or 'empty'; data which is published through them is not
+    // notified and the consumer might sleep with data in the queue
+    Producer& operator*() { return producer; }
+    Producer* operator->() { return &producer; }
+
+private:
+    Producer&      producer;
+    EventNotifier& notifier;
+};
+
+#endif // _EVENT_NOTIFIER_HPP_
@@ -0,0 +1,139 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// SPDX-FileCopyrightText: © 2023 Mathias Kraus <elboberido@m-hias.de>
+
+#ifndef _INDEX_QUEUE_HPP_
+#define _INDEX_QUEUE_HPP_
+
+#include <atomic>
+#include <cstdint>
+
+constexpr uint32_t bitWidth(uint32_t v) {
+    uint32_t width {0};
+    while (v > 0) {
+        ++width;
+        v >>= 1;
+    }
+    return width;
+}
+
+// Lock-free multi producer multi consumer queue for indices, similar to the IndexQueue from iceoryx
+//
+// Each cell is a 32 bit atomic which contains the index and the cycle in which the index was written. A cell is free for the write position
+// when its cycle is one behind the cycle of the write position and it contains a valid index for the read position when the cycles are equal.
+// The queue has no full check. This is fine as long as there are never more than Capacity indices in circulation, which is the case when it
+// is used as a pool for Capacity indices.
+// Since the cycle has to share the 32 bits with the index, it wraps around after 2^(32 - bitWidth(Capacity - 1)) cycles. A thread which is
+// preempted for that many cycles between loading a position and the CAS on the position might suffer from the ABA problem.
+template <uint32_t Capacity>
+class IndexQueue {
+public:
+    static_assert(Capacity > 0, "Capacity must not be 0");
+
+    static constexpr uint32_t INDEX_BITS {bitWidth(Capacity - 1) > 0 ? bitWidth(Capacity - 1) : 1};
+    static constexpr uint32_t CYCLE_BITS {32 - INDEX_BITS};
+    static constexpr uint32_t INDEX_MASK {(1U << INDEX_BITS) - 1};
+    static constexpr uint32_t CYCLE_COUNT {1U << CYCLE_BITS};
+    static constexpr uint64_t POSITION_COUNT {static_cast<uint64_t>(Capacity) * CYCLE_COUNT};
+
+    static_assert(CYCLE_BITS >= 8, "Capacity is too large to fit index and cycle into 32 bit");
+
+    enum class Fill { EMPTY, FULL };
+
+    explicit IndexQueue(Fill fill = Fill::EMPTY) {
+        for (uint32_t i = 0; i < Capacity; ++i) {
+            if (fill == Fill::FULL) {
+                cells[i].store(cell(0, i), std::memory_order_relaxed);
+            } else {
+                cells[i].store(cell(CYCLE_COUNT - 1, 0), std::memory_order_relaxed);
+            }
+        }
+        writePosition.store(fill == Fill::FULL ? Capacity : 0, std::memory_order_relaxed);
+        readPosition.store(0, std::memory_order_relaxed);
+    }
+
+    IndexQueue(const IndexQueue&) = delete;
+    IndexQueue(IndexQueue&&)      = delete;
+
+    IndexQueue& operator=(const IndexQueue&) = delete;
+    IndexQueue& operator=(IndexQueue&&)      = delete;
+
+    void push(uint32_t index) {
+        auto position = writePosition.load(std::memory_order_relaxed);
+
+        constexpr bool KEEP_TRYING {true};
+        do {
+            auto oldCell = cells[position % Capacity].load(std::memory_order_relaxed);
+            if (cycleOfCell(oldCell) == previousCycle(cycleOfPosition(position))) {
+                if (cells[position % Capacity].compare_exchange_strong(
+                        oldCell, cell(cycleOfPosition(position), index), std::memory_order_release, std::memory_order_relaxed)) {
+                    break;
+                }
+                continue;
+            }
+
+            if (cycleOfCell(oldCell) == cycleOfPosition(position)) {
+                // another thread published the index but did not yet advance the write position
+                advance(writePosition, position);
+                continue;
+            }
+
+            position = writePosition.load(std::memory_order_relaxed);
+        } while (KEEP_TRYING);
+
+        // it is fine if this fails since another thread already helped to advance the write position
+        advance(writePosition, position);
+    }
+
+    bool pop(uint32_t& index) {
+        auto position = readPosition.load(std::memory_order_relaxed);
+
+        constexpr bool KEEP_TRYING {true};
+        do {
+            auto value = cells[position % Capacity].load(std::memory_order_acquire);
+            if (cycleOfCell(value) == cycleOfPosition(position)) {
+                auto expectedPosition = position;
+                if (readPosition.compare_exchange_strong(expectedPosition, nextPosition(position), std::memory_order_relaxed, std::memory_order_relaxed)) {
+                    index = value & INDEX_MASK;
+                    return true;
+                }
+                position = expectedPosition;
+            } else if (cycleOfCell(value) == previousCycle(cycleOfPosition(position))) {
+                // queue is empty
+                return false;
+            } else {
+                position = readPosition.load(std::memory_order_relaxed);
+            }
+        } while (KEEP_TRYING);
+
+        return false;
+    }
+
+    bool empty() const {
+        auto position = readPosition.load(std::memory_order_relaxed);
+        return cycleOfCell(cells[position % Capacity].load(std::memory_order_relaxed)) != cycleOfPosition(position);
+    }
+
+private:
+    static constexpr uint32_t cell(uint32_t cycle, uint32_t index) { return (cycle << INDEX_BITS) | index; }
+    static constexpr uint32_t cycleOfCell(uint32_t value) { return value >> INDEX_BITS; }
+    static constexpr uint32_t cycleOfPosition(uint32_t position) { return position / Capacity; }
+    static constexpr uint32_t previousCycle(uint32_t cycle) { return cycle == 0 ? CYCLE_COUNT - 1 : cycle - 1; }
+    static constexpr uint32_t nextPosition(uint32_t position) { return static_cast<uint64_t>(position) + 1 == POSITION_COUNT ? 0 : position + 1; }
+
+    // tries to advance 'atomicPosition' from 'position'; on return 'position' contains the new value of 'atomicPosition'
+    static void advance(std::atomic<uint32_t>& atomicPosition, uint32_t& position) {
+        auto expectedPosition = position;
+        if (atomicPosition.compare_exchange_strong(expectedPosition, nextPosition(position), std::memory_order_relaxed, std::memory_order_relaxed)) {
+            position = nextPosition(position);
+        } else {
+            position = expectedPosition;
+        }
+    }
+
+private:
+    std::atomic<uint32_t> cells[Capacity];
+    std::atomic<uint32_t> writePosition {0};
+    std::atomic<uint32_t> readPosition {0};
+};
+
+#endif // _INDEX_QUEUE_HPP_
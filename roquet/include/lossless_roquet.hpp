@@ -0,0 +1,128 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// SPDX-FileCopyrightText: © 2023 Mathias Kraus <elboberido@m-hias.de>
+
+#ifndef _LOSSLESS_ROQUET_HPP_
+#define _LOSSLESS_ROQUET_HPP_
+
+#include "roquet.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <optional>
+
+// Non-overflowing Robust Queue Transfer
+//
+// Variant of the RoQueT for the return path of the ownership, where no data must be lost. The 'try_push' refuses the data when the queue
+// is full instead of overflowing the oldest element and the data stays with the caller. Since the producer never advances the END over a
+// position with DATA, the consumer is the only one which changes such a state and there is no overflow the 'pop' has to recover from.
+// The 'pop' therefore neither needs the INSPECTED flag to detect the ABA problem nor a CAS to claim the data nor a loop to find the new head.
+// It is a load with acquire semantics of the state at the next position, the copy of the data and a store of EMPTY with release semantics,
+// which makes it wait-free. The states are the same as for the RoQueT and a full queue looks like a full RoQueT without overflow.
+template <typename T, uint64_t Capacity, typename Layout = PackedLayout>
+class LosslessRoQueT {
+public:
+    using Queue = RoQueT<T, Capacity, Layout>;
+
+    static_assert(Capacity != DYNAMIC_CAPACITY, "The LosslessRoQueT requires a capacity which is known at compile time");
+
+    LosslessRoQueT() = default;
+
+    LosslessRoQueT(const LosslessRoQueT&) = delete;
+    LosslessRoQueT(LosslessRoQueT&&)      = delete;
+
+    LosslessRoQueT& operator=(const LosslessRoQueT&) = delete;
+    LosslessRoQueT& operator=(LosslessRoQueT&&)      = delete;
+
+private:
+    class Producer {
+    public:
+        // returns false if the queue is full; the data is not pushed in this case and stays with the caller
+        bool try_push(const T& data) { return roquet.try_push(data, tailPosition); }
+
+        bool empty() { return roquet.queue.emptyForProducer(tailPosition); }
+
+        friend class LosslessRoQueT;
+
+    private:
+        Producer(LosslessRoQueT& r)
+            : roquet(r) {}
+
+    private:
+        LosslessRoQueT& roquet;
+        uint32_t        tailPosition {1};
+    };
+
+    class Consumer {
+    public:
+        std::optional<T> pop() { return roquet.pop(headPosition); }
+
+        bool empty() { return (roquet.queue.stateAt(nextPositionOf(headPosition)).load(std::memory_order_relaxed) & DATA) == 0; }
+
+        friend class LosslessRoQueT;
+
+    private:
+        Consumer(const LosslessRoQueT& r)
+            : roquet(r) {}
+
+    private:
+        const LosslessRoQueT& roquet;
+        uint32_t              headPosition {0};
+    };
+
+public:
+    // TODO return optional<Producer> and ensure that a nullopt is returned after the second call
+    Producer producer() { return Producer(*this); }
+
+    // TODO return optional<Consumer> and ensure that a nullopt is returned after the second call
+    Consumer consumer() { return Consumer(*this); }
+
+private:
+    static constexpr uint8_t DATA {Queue::DATA};
+    static constexpr uint8_t EMPTY {Queue::EMPTY};
+    static constexpr uint8_t END {Queue::END};
+
+    static uint32_t nextPositionOf(uint32_t position) {
+        ++position;
+        if (position >= Queue::InternalCapacity) { position = 0; }
+        return position;
+    }
+
+    bool try_push(const T& data, uint32_t& position) {
+        auto currentPosition = position;
+        auto nextPosition    = nextPositionOf(currentPosition);
+
+        // the acquire pairs with the release store of the consumer and ensures that the consumer finished the copy of the data at the next
+        // position before it is overwritten one push later; only the consumer changes a state with DATA, therefore a relaxed store of the END
+        // is sufficient when there is no DATA
+        if (queue.stateAt(nextPosition).load(std::memory_order_acquire) & DATA) { return false; }
+        queue.stateAt(nextPosition).store(END, std::memory_order_relaxed);
+
+        queue.dataAt(currentPosition) = data;
+        queue.stateAt(currentPosition).store(DATA, std::memory_order_release);
+
+        position = nextPosition;
+        return true;
+    }
+
+    std::optional<T> pop(uint32_t& position) const {
+        // NOTE: don't return nullopt but always resource to make use of NRVO
+        std::optional<T> resource;
+        auto             nextPosition = nextPositionOf(position);
+
+        if ((queue.stateAt(nextPosition).load(std::memory_order_acquire) & DATA) == 0) {
+            // queue is empty
+            return resource;
+        }
+
+        resource.emplace(queue.dataAt(nextPosition));
+        queue.stateAt(nextPosition).store(EMPTY, std::memory_order_release);
+
+        position = nextPosition;
+        return resource;
+    }
+
+private:
+    Queue queue;
+};
+
+#endif // _LOSSLESS_ROQUET_HPP_
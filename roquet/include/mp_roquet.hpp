@@ -0,0 +1,234 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// SPDX-FileCopyrightText: © 2023 Mathias Kraus <elboberido@m-hias.de>
+
+#ifndef _MP_ROQUET_HPP_
+#define _MP_ROQUET_HPP_
+
+#include "index_queue.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+// Multi Producer Robust Queue Transfer
+//
+// The data is stored in chunks which are obtained from an IndexQueue acting as pool. The state buffer holds 32 bit atomics which combine the
+// state flags with the index of the chunk and the cycle in which the state was written. The cycle is required since the producers do not have
+// a local tail position but share the write position. A producer publishes the chunk with a single CAS on the state and in case the state
+// still contained data of the previous cycle, the ownership of the corresponding chunk is transferred to the producer, which returns the data
+// to the user just like RoQueT::push. The consumer is single threaded and claims a chunk with a CAS from DATA to EMPTY.
+//
+// Each producer holds at most one chunk while pushing and the consumer holds at most one chunk while copying the data. The pool has room for
+// 'MaxConcurrentPushes' producers and 'producer()' hands out at most that many at the same time, therefore the pool can never run dry and a
+// push returns data only in case of an overflow.
+template <typename T, uint32_t Capacity, uint32_t MaxConcurrentPushes = 8>
+class MpRoQueT {
+public:
+    static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+    static_assert(Capacity > 0, "Capacity must not be 0");
+    static_assert(MaxConcurrentPushes > 0, "MaxConcurrentPushes must not be 0");
+    static_assert(std::atomic<uint32_t>::is_always_lock_free, "The state must be lock-free");
+
+    // the consumer holds a chunk while copying the data
+    static constexpr uint32_t ChunkCount {Capacity + MaxConcurrentPushes + 1};
+
+    static constexpr uint32_t EMPTY {0x01};
+    static constexpr uint32_t DATA {0x02};
+
+    static constexpr uint32_t FLAG_BITS {2};
+    static constexpr uint32_t INDEX_BITS {bitWidth(ChunkCount - 1)};
+    static constexpr uint32_t CYCLE_BITS {32 - FLAG_BITS - INDEX_BITS};
+    static constexpr uint32_t FLAG_MASK {(1U << FLAG_BITS) - 1};
+    static constexpr uint32_t INDEX_MASK {(1U << INDEX_BITS) - 1};
+    static constexpr uint32_t CYCLE_COUNT {1U << CYCLE_BITS};
+    static constexpr uint64_t POSITION_COUNT {static_cast<uint64_t>(Capacity) * CYCLE_COUNT};
+
+    static_assert(CYCLE_BITS >= 8, "Capacity is too large to fit the state, the index and the cycle into 32 bit");
+
+    MpRoQueT() {
+        for (auto& state : stateBuffer) {
+            state.store(makeState(CYCLE_COUNT - 1, EMPTY, 0), std::memory_order_relaxed);
+        }
+    }
+
+    MpRoQueT(const MpRoQueT&) = delete;
+    MpRoQueT(MpRoQueT&&)      = delete;
+
+    MpRoQueT& operator=(const MpRoQueT&) = delete;
+    MpRoQueT& operator=(MpRoQueT&&)      = delete;
+
+private:
+    class Producer {
+    public:
+        Producer(const Producer&) = delete;
+        Producer(Producer&& other) noexcept
+            : roquet(std::exchange(other.roquet, nullptr)) {}
+
+        Producer& operator=(const Producer&) = delete;
+        Producer& operator=(Producer&&)      = delete;
+
+        ~Producer() {
+            if (roquet != nullptr) { roquet->producerCounter.fetch_sub(1, std::memory_order_release); }
+        }
+
+        std::optional<T> push(const T& data) { return roquet->push(data); }
+
+        friend class MpRoQueT;
+
+    private:
+        Producer(MpRoQueT& r)
+            : roquet(&r) {}
+
+    private:
+        MpRoQueT* roquet;
+    };
+
+    class Consumer {
+    public:
+        std::optional<T> pop() { return roquet.pop(headPosition); }
+
+        bool empty() {
+            auto state = roquet.stateBuffer[headPosition % Capacity].load(std::memory_order_relaxed);
+            return cycleOfState(state) == previousCycle(cycleOfPosition(headPosition));
+        }
+
+        friend class MpRoQueT;
+
+    private:
+        Consumer(MpRoQueT& r)
+            : roquet(r) {}
+
+    private:
+        MpRoQueT& roquet;
+        uint32_t  headPosition {0};
+    };
+
+public:
+    // each producer thread needs its own producer; returns a nullopt if there are already 'MaxConcurrentPushes' producers alive
+    std::optional<Producer> producer() {
+        std::optional<Producer> producer;
+
+        auto count = producerCounter.load(std::memory_order_relaxed);
+        do {
+            if (count >= MaxConcurrentPushes) { return producer; }
+        } while (!producerCounter.compare_exchange_weak(count, count + 1, std::memory_order_acquire, std::memory_order_relaxed));
+
+        producer.emplace(Producer(*this));
+        return producer;
+    }
+
+    // TODO return optional<Consumer> and ensure that a nullopt is returned after the second call
+    Consumer consumer() { return Consumer(*this); }
+
+private:
+    std::optional<T> push(const T& data) {
+        // NOTE: don't return nullopt but always resource to make use of NRVO
+        std::optional<T> resource;
+
+        // the number of producers is limited to 'MaxConcurrentPushes', therefore there is always a free chunk
+        uint32_t index {0};
+        [[maybe_unused]] auto isChunkAvailable = freeChunks.pop(index);
+        assert(isChunkAvailable && "The chunk pool must not run dry!");
+        chunks[index] = data;
+
+        auto position = writePosition.load(std::memory_order_relaxed);
+
+        constexpr bool KEEP_TRYING {true};
+        do {
+            auto& state    = stateBuffer[position % Capacity];
+            auto  oldState = state.load(std::memory_order_acquire);
+
+            if (cycleOfState(oldState) == previousCycle(cycleOfPosition(position))) {
+                if (state.compare_exchange_strong(
+                        oldState, makeState(cycleOfPosition(position), DATA, index), std::memory_order_acq_rel, std::memory_order_acquire)) {
+                    advance(position);
+                    if (flagsOfState(oldState) & DATA) {
+                        // overflow; the consumer did not take the data of the previous cycle
+                        auto overflowIndex = indexOfState(oldState);
+                        resource.emplace(chunks[overflowIndex]);
+                        freeChunks.push(overflowIndex);
+                    }
+                    break;
+                }
+                continue;
+            }
+
+            if (cycleOfState(oldState) == cycleOfPosition(position)) {
+                // another producer published its data but did not yet advance the write position
+                advance(position);
+                continue;
+            }
+
+            position = writePosition.load(std::memory_order_relaxed);
+        } while (KEEP_TRYING);
+
+        return resource;
+    }
+
+    std::optional<T> pop(uint32_t& position) {
+        // NOTE: don't return nullopt but always resource to make use of NRVO
+        std::optional<T> resource;
+
+        constexpr bool KEEP_TRYING {true};
+        do {
+            auto& state        = stateBuffer[position % Capacity];
+            auto  currentState = state.load(std::memory_order_acquire);
+            auto  stateCycle   = cycleOfState(currentState);
+
+            if (stateCycle == previousCycle(cycleOfPosition(position))) {
+                // queue is empty
+                break;
+            }
+
+            if (stateCycle == cycleOfPosition(position) && (flagsOfState(currentState) & DATA)) {
+                auto index = indexOfState(currentState);
+                if (state.compare_exchange_strong(
+                        currentState, makeState(stateCycle, EMPTY, index), std::memory_order_acq_rel, std::memory_order_acquire)) {
+                    resource.emplace(chunks[index]);
+                    freeChunks.push(index);
+                    position = nextPosition(position);
+                    break;
+                }
+                // a producer overwrote the data in the meantime
+                continue;
+            }
+
+            // there was an overflow and the state belongs to a later cycle; the data will be popped when the head position gets there
+            position = nextPosition(position);
+        } while (KEEP_TRYING);
+
+        return resource;
+    }
+
+    // tries to advance the write position from 'position'; on return 'position' contains the new write position
+    void advance(uint32_t& position) {
+        auto expectedPosition = position;
+        if (writePosition.compare_exchange_strong(expectedPosition, nextPosition(position), std::memory_order_relaxed, std::memory_order_relaxed)) {
+            position = nextPosition(position);
+        } else {
+            position = expectedPosition;
+        }
+    }
+
+    static constexpr uint32_t makeState(uint32_t cycle, uint32_t flags, uint32_t index) {
+        return (cycle << (FLAG_BITS + INDEX_BITS)) | (flags << INDEX_BITS) | index;
+    }
+    static constexpr uint32_t cycleOfState(uint32_t state) { return state >> (FLAG_BITS + INDEX_BITS); }
+    static constexpr uint32_t flagsOfState(uint32_t state) { return (state >> INDEX_BITS) & FLAG_MASK; }
+    static constexpr uint32_t indexOfState(uint32_t state) { return state & INDEX_MASK; }
+    static constexpr uint32_t cycleOfPosition(uint32_t position) { return position / Capacity; }
+    static constexpr uint32_t previousCycle(uint32_t cycle) { return cycle == 0 ? CYCLE_COUNT - 1 : cycle - 1; }
+    static constexpr uint32_t nextPosition(uint32_t position) { return static_cast<uint64_t>(position) + 1 == POSITION_COUNT ? 0 : position + 1; }
+
+private:
+    std::atomic<uint32_t> stateBuffer[Capacity];
+    std::atomic<uint32_t> writePosition {0};
+    std::atomic<uint32_t> producerCounter {0};
+    IndexQueue<ChunkCount> freeChunks {IndexQueue<ChunkCount>::Fill::FULL};
+    T                      chunks[ChunkCount];
+};
+
+#endif // _MP_ROQUET_HPP_
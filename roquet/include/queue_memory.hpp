@@ -0,0 +1,135 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// SPDX-FileCopyrightText: © 2023 Mathias Kraus <elboberido@m-hias.de>
+
+#ifndef _QUEUE_MEMORY_HPP_
+#define _QUEUE_MEMORY_HPP_
+
+#include <cstdint>
+#include <optional>
+#include <utility>
+
+#include <linux/mempolicy.h>
+#include <linux/mman.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// Memory for the rings of a RoQueT or BuRiTTO with a dynamic capacity
+//
+// Large rings suffer from TLB misses when they are backed by regular pages. The memory can therefore be backed by 2 MiB or 1 GiB hugepages.
+// If the requested page size is not available, the next smaller one is tried and when it falls back to regular pages, they are advised to
+// be backed by transparent hugepages. The memory can additionally be bound to a NUMA node, e.g. the one of the consumer. The binding is done
+// before the memory is touched for the first time, i.e. before the queue is constructed in the memory, therefore all pages are allocated on
+// this node.
+class QueueMemory {
+public:
+    enum class PageSize : uint8_t { REGULAR, HUGE_2MIB, HUGE_1GIB };
+
+    static constexpr int32_t NO_NUMA_NODE {-1};
+
+    // maps at least 'size' bytes with the 'pageSize' or a smaller page size if it is not available and binds them to the 'numaNode'
+    static std::optional<QueueMemory> allocate(uint64_t size, PageSize pageSize, int32_t numaNode = NO_NUMA_NODE) {
+        std::optional<QueueMemory> memory;
+
+        const auto requestedPageSize = pageSize;
+        void*      address {MAP_FAILED};
+        while (true) {
+            auto mappedSize = alignUp(size, page_size_in_bytes(pageSize));
+            address         = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | mapFlags(pageSize), -1, 0);
+            if (address != MAP_FAILED) {
+                memory.emplace(QueueMemory(address, mappedSize, pageSize));
+                // only the fallback to regular pages is advised; a hugetlb mapping with a smaller page size is not affected by the advice
+                if (pageSize == PageSize::REGULAR && requestedPageSize != PageSize::REGULAR) {
+                    memory->isHugepageAdvised = madvise(address, mappedSize, MADV_HUGEPAGE) == 0;
+                }
+                break;
+            }
+            if (pageSize == PageSize::REGULAR) { return memory; }
+            pageSize = pageSize == PageSize::HUGE_1GIB ? PageSize::HUGE_2MIB : PageSize::REGULAR;
+        }
+
+        if (numaNode != NO_NUMA_NODE && numaNode < static_cast<int32_t>(sizeof(unsigned long) * 8)) {
+            unsigned long nodeMask {1UL << numaNode};
+            memory->numaNode = syscall(SYS_mbind, memory->address, memory->mappedSize, MPOL_BIND, &nodeMask, sizeof(nodeMask) * 8, 0) == 0
+                                   ? numaNode
+                                   : NO_NUMA_NODE;
+        }
+
+        return memory;
+    }
+
+    // the NUMA node of the CPU the calling thread is currently running on; used by the consumer to allocate the memory on its own node
+    static int32_t current_numa_node() {
+        unsigned cpu {0};
+        unsigned node {0};
+        if (syscall(SYS_getcpu, &cpu, &node, nullptr) != 0) { return NO_NUMA_NODE; }
+        return static_cast<int32_t>(node);
+    }
+
+    static constexpr uint64_t page_size_in_bytes(PageSize pageSize) {
+        switch (pageSize) {
+        case PageSize::HUGE_2MIB:
+            return 2ULL << 20;
+        case PageSize::HUGE_1GIB:
+            return 1ULL << 30;
+        default:
+            return 4096;
+        }
+    }
+
+    QueueMemory(const QueueMemory&) = delete;
+    QueueMemory(QueueMemory&& rhs) noexcept
+        : address(std::exchange(rhs.address, nullptr))
+        , mappedSize(std::exchange(rhs.mappedSize, 0))
+        , pageSize(rhs.pageSize)
+        , numaNode(rhs.numaNode)
+        , isHugepageAdvised(rhs.isHugepageAdvised) {}
+
+    QueueMemory& operator=(const QueueMemory&) = delete;
+    QueueMemory& operator=(QueueMemory&&)      = delete;
+
+    ~QueueMemory() {
+        if (address != nullptr) { munmap(address, mappedSize); }
+    }
+
+    void* get() const { return address; }
+
+    uint64_t size() const { return mappedSize; }
+
+    // the page size which is actually used, which might be smaller than the requested one
+    PageSize page_size() const { return pageSize; }
+
+    // the NUMA node the memory is bound to or 'NO_NUMA_NODE' if the memory is not bound
+    int32_t numa_node() const { return numaNode; }
+
+    // whether the memory fell back to regular pages which are advised to be backed by transparent hugepages
+    bool hugepage_advised() const { return isHugepageAdvised; }
+
+private:
+    QueueMemory(void* a, uint64_t s, PageSize p)
+        : address(a)
+        , mappedSize(s)
+        , pageSize(p) {}
+
+    static constexpr uint64_t alignUp(uint64_t value, uint64_t alignment) { return (value + alignment - 1) / alignment * alignment; }
+
+    static int mapFlags(PageSize pageSize) {
+        switch (pageSize) {
+        case PageSize::HUGE_2MIB:
+            return MAP_HUGETLB | MAP_HUGE_2MB;
+        case PageSize::HUGE_1GIB:
+            return MAP_HUGETLB | MAP_HUGE_1GB;
+        default:
+            return 0;
+        }
+    }
+
+private:
+    void*    address {nullptr};
+    uint64_t mappedSize {0};
+    PageSize pageSize {PageSize::REGULAR};
+    int32_t  numaNode {NO_NUMA_NODE};
+    bool     isHugepageAdvised {false};
+};
+
+#endif // _QUEUE_MEMORY_HPP_
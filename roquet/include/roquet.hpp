@@ -6,12 +6,224 @@
 
 #include <atomic>
 #include <cassert>
+#include <chrono>
 #include <cstdint>
+#include <ctime>
+#include <new>
 #include <optional>
 #include <type_traits>
 
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
 #include <iostream>
 
+constexpr uint64_t CACHE_LINE_SIZE {64};
+
+// the capacity of the RoQueT is set at construction and the states and the data are placed in caller-provided memory
+constexpr uint64_t DYNAMIC_CAPACITY {0};
+
+constexpr uint64_t alignUp(uint64_t value, uint64_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// the outcome of a push; a corrupted queue does not accept the data
+enum class PushStatus : uint8_t { PUSHED, OVERFLOWED, CORRUPT };
+
+// the outcome of a pop; data is only returned with DATA and OVERFLOW_RECOVERED, the latter indicates that the consumer had to find the
+// new head after an overflow and that data was lost
+enum class PopStatus : uint8_t { DATA, OVERFLOW_RECOVERED, EMPTY, RETRY_BUDGET_EXHAUSTED, CORRUPT };
+
+// finds the first position in [from, to) with a state which contains one of the 'flags' and returns 'to' if there is none; the result is
+// only a candidate since the states are loaded relaxed and must be confirmed with a precise load
+template <typename Storage>
+uint64_t findStateScalar(const Storage& storage, uint64_t from, uint64_t to, uint8_t flags) {
+    for (; from < to; ++from) {
+        if (storage.state(from).load(std::memory_order_relaxed) & flags) { return from; }
+    }
+    return to;
+}
+
+// same as above for consecutive states, which are scanned 32 or 16 at a time with AVX2 or SSE2; the atomics are read as plain bytes, which
+// is fine for a candidate since a byte-sized atomic has the representation of a byte and the candidate is confirmed with an atomic load
+inline uint64_t findStateConsecutive(const std::atomic<uint8_t>* states, uint64_t from, uint64_t to, uint8_t flags) {
+    static_assert(sizeof(std::atomic<uint8_t>) == 1, "The states must be scannable as bytes");
+#if defined(__AVX2__)
+    const auto bytes     = reinterpret_cast<const uint8_t*>(states);
+    const auto flagsMask = _mm256_set1_epi8(static_cast<char>(flags));
+    for (; from + 32 <= to; from += 32) {
+        auto chunk   = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes + from));
+        auto noFlags = _mm256_cmpeq_epi8(_mm256_and_si256(chunk, flagsMask), _mm256_setzero_si256());
+        auto hits    = ~static_cast<uint32_t>(_mm256_movemask_epi8(noFlags));
+        if (hits != 0) { return from + static_cast<uint64_t>(__builtin_ctz(hits)); }
+    }
+#elif defined(__SSE2__)
+    const auto bytes     = reinterpret_cast<const uint8_t*>(states);
+    const auto flagsMask = _mm_set1_epi8(static_cast<char>(flags));
+    for (; from + 16 <= to; from += 16) {
+        auto chunk   = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + from));
+        auto noFlags = _mm_cmpeq_epi8(_mm_and_si128(chunk, flagsMask), _mm_setzero_si128());
+        auto hits    = ~static_cast<uint32_t>(_mm_movemask_epi8(noFlags)) & 0xFFFFU;
+        if (hits != 0) { return from + static_cast<uint64_t>(__builtin_ctz(hits)); }
+    }
+#endif
+    for (; from < to; ++from) {
+        if (states[from].load(std::memory_order_relaxed) & flags) { return from; }
+    }
+    return to;
+}
+
+// The layout policies define how the states and the data of the RoQueT are placed in memory;
+// the packed layout places as many states as possible on a cache line at the cost of false sharing between producer and consumer
+struct PackedLayout {
+    template <typename T, uint64_t Capacity>
+    struct Storage {
+        std::atomic<uint8_t>& state(uint64_t position) const { return stateBuffer[position]; }
+        T&                    data(uint64_t position) { return dataBuffer[position]; }
+        const T&              data(uint64_t position) const { return dataBuffer[position]; }
+        uint64_t find(uint64_t from, uint64_t to, uint8_t flags) const { return findStateConsecutive(stateBuffer, from, to, flags); }
+
+        mutable std::atomic<uint8_t> stateBuffer[Capacity];
+        T                            dataBuffer[Capacity];
+    };
+
+    template <typename T>
+    struct DynamicStorage {
+        static constexpr uint64_t ALIGNMENT {alignof(T)};
+
+        static uint64_t dataOffset(uint64_t capacity) { return alignUp(capacity * sizeof(std::atomic<uint8_t>), alignof(T)); }
+        static uint64_t memorySize(uint64_t capacity) { return dataOffset(capacity) + capacity * sizeof(T); }
+
+        DynamicStorage(void* memory, uint64_t c)
+            : capacity(c)
+            , stateBuffer(static_cast<std::atomic<uint8_t>*>(memory))
+            , dataBuffer(reinterpret_cast<T*>(static_cast<uint8_t*>(memory) + dataOffset(c))) {
+            for (uint64_t i = 0; i < capacity; ++i) {
+                new (&stateBuffer[i]) std::atomic<uint8_t>;
+            }
+        }
+
+        std::atomic<uint8_t>& state(uint64_t position) const { return stateBuffer[position]; }
+        T&                    data(uint64_t position) { return dataBuffer[position]; }
+        const T&              data(uint64_t position) const { return dataBuffer[position]; }
+        uint64_t find(uint64_t from, uint64_t to, uint8_t flags) const { return findStateConsecutive(stateBuffer, from, to, flags); }
+
+        uint64_t              capacity;
+        std::atomic<uint8_t>* stateBuffer;
+        T*                    dataBuffer;
+    };
+};
+
+// each state is placed on its own cache line which prevents false sharing of the states at the cost of memory
+struct PaddedLayout {
+    template <typename T, uint64_t Capacity>
+    struct Storage {
+        std::atomic<uint8_t>& state(uint64_t position) const { return stateBuffer[position].state; }
+        T&                    data(uint64_t position) { return dataBuffer[position]; }
+        const T&              data(uint64_t position) const { return dataBuffer[position]; }
+        uint64_t              find(uint64_t from, uint64_t to, uint8_t flags) const { return findStateScalar(*this, from, to, flags); }
+
+        struct alignas(CACHE_LINE_SIZE) PaddedState {
+            std::atomic<uint8_t> state;
+        };
+
+        mutable PaddedState stateBuffer[Capacity];
+        T                   dataBuffer[Capacity];
+    };
+
+    template <typename T>
+    struct DynamicStorage {
+        struct alignas(CACHE_LINE_SIZE) PaddedState {
+            std::atomic<uint8_t> state;
+        };
+
+        static constexpr uint64_t ALIGNMENT {alignof(PaddedState) > alignof(T) ? alignof(PaddedState) : alignof(T)};
+
+        static uint64_t dataOffset(uint64_t capacity) { return alignUp(capacity * sizeof(PaddedState), alignof(T)); }
+        static uint64_t memorySize(uint64_t capacity) { return dataOffset(capacity) + capacity * sizeof(T); }
+
+        DynamicStorage(void* memory, uint64_t c)
+            : capacity(c)
+            , stateBuffer(static_cast<PaddedState*>(memory))
+            , dataBuffer(reinterpret_cast<T*>(static_cast<uint8_t*>(memory) + dataOffset(c))) {
+            for (uint64_t i = 0; i < capacity; ++i) {
+                new (&stateBuffer[i]) PaddedState;
+            }
+        }
+
+        std::atomic<uint8_t>& state(uint64_t position) const { return stateBuffer[position].state; }
+        T&                    data(uint64_t position) { return dataBuffer[position]; }
+        const T&              data(uint64_t position) const { return dataBuffer[position]; }
+        uint64_t              find(uint64_t from, uint64_t to, uint8_t flags) const { return findStateScalar(*this, from, to, flags); }
+
+        uint64_t     capacity;
+        PaddedState* stateBuffer;
+        T*           dataBuffer;
+    };
+};
+
+// the state is placed next to its data which results in only one cache line to be touched for small data types
+struct InterleavedLayout {
+    template <typename T, uint64_t Capacity>
+    struct Storage {
+        std::atomic<uint8_t>& state(uint64_t position) const { return slots[position].state; }
+        T&                    data(uint64_t position) { return slots[position].data; }
+        const T&              data(uint64_t position) const { return slots[position].data; }
+        uint64_t              find(uint64_t from, uint64_t to, uint8_t flags) const { return findStateScalar(*this, from, to, flags); }
+
+        struct Slot {
+            mutable std::atomic<uint8_t> state;
+            T                            data;
+        };
+
+        Slot slots[Capacity];
+    };
+
+    template <typename T>
+    struct DynamicStorage {
+        struct Slot {
+            mutable std::atomic<uint8_t> state;
+            T                            data;
+        };
+
+        static constexpr uint64_t ALIGNMENT {alignof(Slot)};
+
+        static uint64_t memorySize(uint64_t capacity) { return capacity * sizeof(Slot); }
+
+        DynamicStorage(void* memory, uint64_t c)
+            : capacity(c)
+            , slots(static_cast<Slot*>(memory)) {
+            for (uint64_t i = 0; i < capacity; ++i) {
+                new (&slots[i].state) std::atomic<uint8_t>;
+            }
+        }
+
+        std::atomic<uint8_t>& state(uint64_t position) const { return slots[position].state; }
+        T&                    data(uint64_t position) { return slots[position].data; }
+        const T&              data(uint64_t position) const { return slots[position].data; }
+        uint64_t              find(uint64_t from, uint64_t to, uint8_t flags) const { return findStateScalar(*this, from, to, flags); }
+
+        uint64_t capacity;
+        Slot*    slots;
+    };
+};
+
+// The statistics policies define whether the RoQueT counts its operations; the counters are only written by one side, therefore they are
+// incremented with a load and a store instead of a read-modify-write and can be read by any thread with a relaxed load. Without statistics
+// the counters and their updates are compiled out.
+struct NoStatistics {
+    static constexpr bool ENABLED {false};
+};
+
+struct OperationStatistics {
+    static constexpr bool ENABLED {true};
+};
+
 // Robust Queue Transfer
 //
 // A proof-of-concept for a robust queue which could be used for e.g. a zero copy dbus implementation.
@@ -26,47 +238,235 @@
 // of Linux RCU mechanism can be borrowed.
 // TODO: evaluate which queue Wayland IPC used; potentially a FIFO since it is not allowed to lose commands
 // TODO: evaluate whether more of the ideas from BuRiTTO can be combined with RoQueT or whether BuRiTTO can be made resilient
-template <typename T, uint64_t Capacity>
+// the 'Blocking' parameter enables 'pop_wait'; the producer then has to check for a waiting consumer with a fence on each push, which is
+// not paid by a RoQueT without blocking pop
+template <typename T, uint64_t Capacity, typename Layout = PackedLayout, typename Statistics = NoStatistics, bool Blocking = false>
 class RoQueT {
 public:
     static_assert(std::is_trivially_copyable_v<T>,
                   "T must be trivially copyable"); // TODO this restriction might be too strict; have to think about the use case
 
-    static constexpr uint64_t InternalCapacity {Capacity + 2};
+    // the internal capacity of a RoQueT with a dynamic capacity is only known at runtime
+    static constexpr uint64_t InternalCapacity {Capacity == DYNAMIC_CAPACITY ? 0 : Capacity + 2};
 
     static constexpr uint8_t EMPTY {0x01};
     static constexpr uint8_t PENDING {0x02};
     static constexpr uint8_t DATA {0x04};
     static constexpr uint8_t OVERFLOW {0x08};
     static constexpr uint8_t INSPECTED {0x10};
+    // only used by the TransactionalRoQueT; set by the consumer when it claims data and preserved by the producer until the consumer
+    // finished its transaction
+    static constexpr uint8_t CLAIMED {0x20};
+    // set by the producer when it withdraws data which was pushed with 'push_cancellable'; the consumer skips such a position
+    static constexpr uint8_t CANCELED {0x40};
     static constexpr uint8_t END {0x80};
 
+    template <uint64_t C = Capacity, std::enable_if_t<C != DYNAMIC_CAPACITY, int> = 0>
     RoQueT() {
-        for (auto& idx : stateBuffer) {
-            idx.store(EMPTY, std::memory_order_relaxed);
-        }
-        stateBuffer[1].store(END, std::memory_order_relaxed);
+        init();
     }
 
+    // the capacity is set at construction and the states and the data are placed in the 'memory', which must have 'required_memory_size'
+    // bytes with an alignment of 'memory_alignment' and must outlive the RoQueT; the memory can come from an allocator or a raw memory region
+    template <uint64_t C = Capacity, std::enable_if_t<C == DYNAMIC_CAPACITY, int> = 0>
+    RoQueT(uint64_t capacity, void* memory)
+        : storage(memory, capacity + 2) {
+        assert(capacity > 0 && capacity + 2 < (1ULL << 32) && "Capacity out of range");
+        assert(reinterpret_cast<uintptr_t>(memory) % memory_alignment() == 0 && "Memory is not aligned");
+        init();
+    }
+
+    static uint64_t required_memory_size(uint64_t capacity) {
+        static_assert(Capacity == DYNAMIC_CAPACITY, "Only a RoQueT with a dynamic capacity uses caller-provided memory");
+        return Layout::template DynamicStorage<T>::memorySize(capacity + 2);
+    }
+
+    static constexpr uint64_t memory_alignment() {
+        static_assert(Capacity == DYNAMIC_CAPACITY, "Only a RoQueT with a dynamic capacity uses caller-provided memory");
+        return Layout::template DynamicStorage<T>::ALIGNMENT;
+    }
+
+    uint64_t capacity() const { return internalCapacity() - 2; }
+
     RoQueT(const RoQueT&) = delete;
     RoQueT(RoQueT&&)      = delete;
 
     RoQueT& operator=(const RoQueT&) = delete;
     RoQueT& operator=(RoQueT&&)      = delete;
 
+    struct PushResult {
+        PushStatus       status {PushStatus::PUSHED};
+        std::optional<T> overflow;
+    };
+
+    struct PopResult {
+        PopStatus        status {PopStatus::EMPTY};
+        std::optional<T> data;
+        // the number of elements which were lost since the last reported overflow; only set with OVERFLOW_RECOVERED
+        uint64_t lost {0};
+    };
+
+    // handle to data which was pushed with 'push_cancellable'; the generation is the sequence number of the push and is used to detect
+    // whether the position was reused by a later push in the meantime
+    struct CancelHandle {
+        uint32_t position {0};
+        uint64_t generation {INVALID_GENERATION};
+    };
+
+    // the default number of wrap-arounds the search for the new head after an overflow may take per 'pop'
+    static constexpr uint64_t DEFAULT_WRAP_AROUND_BUDGET {4};
+
+    // snapshot of the operation counters; the counters are loaded one after another while the producer and the consumer continue,
+    // therefore they are not consistent to each other, e.g. there might be more pops than pushes
+    struct Counters {
+        uint64_t pushes {0};
+        uint64_t overflows {0};
+        uint64_t pops {0};
+        // the additional iterations of 'pop' due to an overflow or a concurrent push
+        uint64_t popRetries {0};
+        // the failed CAS operations in 'pop' when setting the INSPECTED flag or claiming the data
+        uint64_t casFailures {0};
+    };
+
+    // can be called from any thread, e.g. a monitoring thread
+    Counters counters() const {
+        static_assert(Statistics::ENABLED, "The counters are only available with 'OperationStatistics'");
+        Counters snapshot;
+        snapshot.pushes      = pushCounter.load(std::memory_order_relaxed);
+        snapshot.overflows   = overflowCounter.load(std::memory_order_relaxed);
+        snapshot.pops        = consumerCounters.pops.load(std::memory_order_relaxed);
+        snapshot.popRetries  = consumerCounters.popRetries.load(std::memory_order_relaxed);
+        snapshot.casFailures = consumerCounters.casFailures.load(std::memory_order_relaxed);
+        return snapshot;
+    }
+
 private:
+    static constexpr uint64_t INVALID_GENERATION {UINT64_MAX};
+
+    // the progress of the search for the new head after an overflow; it is kept by the consumer when the budget is exhausted to continue
+    // the search with the next operation instead of starting again at the head position
+    struct Search {
+        uint64_t budget {DEFAULT_WRAP_AROUND_BUDGET};
+        uint32_t position {0};
+        uint64_t inspected {0};
+        bool     active {false};
+        // the value of the overflow counter at the last reported overflow
+        uint64_t reportedOverflows {0};
+    };
+
+    // handle to the slot at the tail position which was reserved by 'Producer::loan'
+    class Loan {
+    public:
+        T& operator*() { return *data; }
+        T* operator->() { return data; }
+
+        // the data which was overflowed when the slot was reserved or a nullptr; the ownership is transferred to the producer and the data
+        // stays valid until the next 'loan' or 'push'
+        const T* overflow() const { return overflowedData; }
+
+        friend class RoQueT;
+
+    private:
+        Loan(T* d, const T* o, uint32_t p)
+            : data(d)
+            , overflowedData(o)
+            , position(p) {}
+
+    private:
+        T*       data {nullptr};
+        const T* overflowedData {nullptr};
+        uint32_t position {0};
+    };
+
+    // the outcome of a 'loan'; the loan is only set with PUSHED and OVERFLOWED, the latter indicates that 'Loan::overflow' is set
+    struct LoanResult {
+        PushStatus          status {PushStatus::PUSHED};
+        std::optional<Loan> loan;
+    };
+
+    // the outcome of the internal 'push_batch'; the number of pushed elements is less than the requested count if the queue is corrupt
+    struct BatchResult {
+        PushStatus status {PushStatus::PUSHED};
+        uint64_t   pushed {0};
+    };
+
+    // handle to the data at the head position which was inspected by 'Consumer::borrow'
+    class Borrow {
+    public:
+        const T& operator*() const { return *data; }
+        const T* operator->() const { return data; }
+
+        // either DATA or OVERFLOW_RECOVERED like with 'pop_checked'
+        PopStatus status() const { return popStatus; }
+
+        // the number of elements which were lost since the last reported overflow; only set with OVERFLOW_RECOVERED
+        uint64_t lost() const { return lostElements; }
+
+        friend class RoQueT;
+
+    private:
+        Borrow(const T* d, uint32_t c, uint32_t n, uint8_t s)
+            : data(d)
+            , currentPosition(c)
+            , nextPosition(n)
+            , stateNextPosition(s) {}
+
+    private:
+        const T*  data {nullptr};
+        uint32_t  currentPosition {0};
+        uint32_t  nextPosition {0};
+        uint8_t   stateNextPosition {0};
+        PopStatus popStatus {PopStatus::DATA};
+        uint64_t  lostElements {0};
+    };
+
     class Producer {
     public:
-        std::optional<T> push(const T& data) { return roquet.push(data, tailPosition); }
+        std::optional<T> push(const T& data) { return push_checked(data).overflow; }
 
-        bool empty() {
-            auto preceedingPosition = tailPosition;
-            if (preceedingPosition == 0) { preceedingPosition = RoQueT::InternalCapacity; }
-            --preceedingPosition;
+        // like 'push' but also reports a corrupted queue, which is otherwise indistinguishable from a push without overflow
+        PushResult push_checked(const T& data) {
+            auto result = roquet.push(data, tailPosition);
+            if (result.status != PushStatus::CORRUPT) { ++generation; }
+            roquet.notify();
+            return result;
+        }
 
-            return (roquet.stateBuffer[preceedingPosition].load(std::memory_order_relaxed) & RoQueT::DATA) == 0;
+        // like 'push_checked' but hands out a handle to withdraw the data with 'cancel' as long as the consumer did not take it; the handle
+        // is invalid if the queue is corrupt
+        PushResult push_cancellable(const T& data, CancelHandle& handle) {
+            handle.position   = tailPosition;
+            handle.generation = generation;
+            auto result       = push_checked(data);
+            if (result.status == PushStatus::CORRUPT) { handle = CancelHandle {}; }
+            return result;
         }
 
+        // withdraws the data of the 'handle'; returns false if the data was already taken or inspected by the consumer, was overflowed or
+        // was already canceled
+        bool cancel(const CancelHandle& handle) { return roquet.cancel(handle, generation); }
+
+        // reserves the slot at the tail position to construct the data in place; the data is published with 'commit', which has to be called
+        // before the next 'loan' or 'push'; a corrupted queue is reported with CORRUPT and without a loan
+        LoanResult loan() { return roquet.loan(tailPosition); }
+        void                commit(Loan& loan) {
+            roquet.commit(loan, tailPosition);
+            ++generation;
+            roquet.notify();
+        }
+
+        // pushes 'count' elements which become visible to the consumer at once; overflowed elements are passed to the 'overflowCallback';
+        // with CORRUPT, only the chunks before the corrupted state were pushed
+        template <typename F>
+        PushStatus push_batch(const T* data, uint64_t count, F&& overflowCallback) {
+            auto result = roquet.push_batch(data, count, overflowCallback, tailPosition);
+            generation += result.pushed;
+            roquet.notify();
+            return result.status;
+        }
+
+        bool empty() { return roquet.emptyForProducer(tailPosition); }
+
         friend class RoQueT;
 
     private:
@@ -76,27 +476,49 @@ private:
     private:
         RoQueT&  roquet;
         uint32_t tailPosition {1};
+        // the number of pushes which advanced the tail position; used as generation of the 'CancelHandle'
+        uint64_t generation {0};
     };
 
     class Consumer {
     public:
-        std::optional<T> pop() { return roquet.pop(headPosition); }
+        std::optional<T> pop() { return roquet.pop(headPosition, search); }
 
-        bool empty() {
-            auto isCurrentEmpty = [this] {
-                auto currentPosition = this->headPosition;
-                return this->roquet.stateBuffer[currentPosition].load(std::memory_order_relaxed) & RoQueT::EMPTY;
-            };
+        // like 'pop' but separates an empty queue from an exhausted retry budget and a corrupted queue and reports a recovered overflow
+        PopResult pop_checked() { return roquet.pop_checked(headPosition, search); }
 
-            auto isNextEndOrPending = [this] {
-                auto nextPosition = this->headPosition;
-                ++nextPosition;
-                if (nextPosition == RoQueT::InternalCapacity) { nextPosition = 0; }
-                auto state = this->roquet.stateBuffer[nextPosition].load(std::memory_order_relaxed);
-                return (state & (RoQueT::END | RoQueT::PENDING));
-            };
+        // like 'pop' but waits up to 'timeout' for data; the queue is polled for a short while before the consumer goes to sleep and the
+        // producer only wakes it up when it is waiting
+        std::optional<T> pop_wait(std::chrono::nanoseconds timeout) { return roquet.pop_wait(headPosition, search, timeout); }
 
-            return (isCurrentEmpty() && isNextEndOrPending());
+        // pops up to 'max' elements into 'out' and returns the number of popped elements
+        uint64_t pop_batch(T* out, uint64_t max) {
+            auto store = [&out](const T& data) { *out++ = data; };
+            return roquet.pop_run(store, max, headPosition, search);
+        }
+
+        // passes the data to 'f' until the queue is empty but at most one wrap-around to not starve on a fast producer;
+        // returns the number of popped elements
+        template <typename F>
+        uint64_t drain(F&& f) {
+            return roquet.pop_run(f, roquet.internalCapacity(), headPosition, search);
+        }
+
+        // gives read-only access to the data at the head position without copying it; the data is claimed with 'release', which has to be
+        // called before the next operation of the consumer
+        std::optional<Borrow> borrow() { return roquet.borrow(headPosition, search); }
+
+        // claims the borrowed data; returns false if the producer overwrote the data during the read, which must then be discarded; the
+        // overflow is reported by the next 'borrow'
+        bool release(Borrow& borrow) { return roquet.release(borrow, headPosition, search); }
+
+        bool empty() { return roquet.emptyForConsumer(headPosition); }
+
+        // sets the number of wrap-arounds the search for the new head after an overflow may take per operation; when the budget is
+        // exhausted, the operation returns without data and the next one continues the search where it stopped
+        void set_wrap_around_budget(uint64_t wrapArounds) {
+            assert(wrapArounds > 0 && "The budget must allow at least one wrap-around");
+            search.budget = wrapArounds;
         }
 
         friend class RoQueT;
@@ -108,6 +530,7 @@ private:
     private:
         const RoQueT& roquet;
         uint32_t      headPosition {0};
+        Search        search;
     };
 
 public:
@@ -120,132 +543,686 @@ public:
     Consumer consumer() { return Consumer(*this); }
 
 private:
+    template <typename, uint64_t, typename>
+    friend class TransactionalRoQueT;
+    template <typename, uint64_t, typename>
+    friend class WaitFreeRoQueT;
+    template <typename, uint64_t, typename>
+    friend class LosslessRoQueT;
+
+    bool emptyForProducer(uint32_t tailPosition) const {
+        auto preceedingPosition = tailPosition;
+        if (preceedingPosition == 0) { preceedingPosition = internalCapacity(); }
+        --preceedingPosition;
+
+        return (stateAt(preceedingPosition).load(std::memory_order_relaxed) & DATA) == 0;
+    }
+
+    bool emptyForConsumer(uint32_t headPosition) const {
+        auto isCurrentEmpty = [&] {
+            auto currentPosition = headPosition;
+            return stateAt(currentPosition).load(std::memory_order_relaxed) & EMPTY;
+        };
+
+        auto isNextEndOrPending = [&] {
+            auto nextPosition = headPosition;
+            ++nextPosition;
+            if (nextPosition == internalCapacity()) { nextPosition = 0; }
+            auto state = stateAt(nextPosition).load(std::memory_order_relaxed);
+            return (state & (END | PENDING));
+        };
+
+        return (isCurrentEmpty() && isNextEndOrPending());
+    }
+
     // TODO use tuple instead of out-parameter
-    std::optional<T> push(const T& data, uint32_t& position) {
-        assert(position < InternalCapacity && "Position out of bounds");
+    PushResult push(const T& data, uint32_t& position) {
+        assert(position < internalCapacity() && "Position out of bounds");
+
+        // NOTE: don't return a temporary but always result to make use of NRVO
+        PushResult result;
+        auto       currentPosition = position;
+        auto       nextPosition    = currentPosition + 1;
+        if (nextPosition >= internalCapacity()) { nextPosition = 0; }
+
+        if (!advanceEnd(nextPosition, result.overflow)) {
+            // at this point the state at the next tail position should contain the END flag
+            result.overflow.reset();
+            result.status = PushStatus::CORRUPT;
+            return result;
+        }
+
+        dataAt(currentPosition) = data;
+        publish(currentPosition);
+        countPushes(1);
+
+        if (result.overflow.has_value()) { result.status = PushStatus::OVERFLOWED; }
+        position = nextPosition;
+        return result;
+    }
+
+    LoanResult loan(uint32_t position) {
+        assert(position < internalCapacity() && "Position out of bounds");
+
+        // NOTE: don't return a temporary but always result to make use of NRVO
+        LoanResult result;
+        auto       nextPosition = position + 1;
+        if (nextPosition >= internalCapacity()) { nextPosition = 0; }
+
+        bool overflow {false};
+        if (!advanceEnd(nextPosition, overflow)) {
+            // at this point the state at the next tail position should contain the END flag
+            result.status = PushStatus::CORRUPT;
+            return result;
+        }
+
+        result.loan.emplace(Loan(&dataAt(position), overflow ? &dataAt(nextPosition) : nullptr, position));
+        if (overflow) { result.status = PushStatus::OVERFLOWED; }
+        return result;
+    }
+
+    void commit(Loan& loan, uint32_t& position) {
+        assert(loan.position == position && "The loan does not belong to the tail position");
+
+        publish(position);
+        countPushes(1);
+        loan.data = nullptr;
+
+        ++position;
+        if (position >= internalCapacity()) { position = 0; }
+    }
+
+    template <typename F>
+    BatchResult push_batch(const T* data, uint64_t count, F& overflowCallback, uint32_t& position) {
+        assert(position < internalCapacity() && "Position out of bounds");
+
+        // NOTE: don't return a temporary but always result to make use of NRVO
+        BatchResult result;
+        while (count > 0) {
+            // the batch must not overrun itself, therefore it is split into chunks which fit into the queue
+            const auto chunkSize = static_cast<uint32_t>(count < capacity() ? count : capacity());
+
+            auto firstPosition = position;
+            auto endPosition   = firstPosition + chunkSize;
+            if (endPosition >= internalCapacity()) { endPosition -= internalCapacity(); }
 
-        // NOTE: don't return nullopt but always resource to make use of NRVO
-        std::optional<T> resource;
-        auto             currentPosition = position;
-        auto             nextPosition    = currentPosition + 1;
-        if (nextPosition >= InternalCapacity) { nextPosition = 0; }
+            std::optional<T> resource;
+            if (!advanceEnd(endPosition, resource)) {
+                // at this point the state at the new tail position should contain the END flag
+                result.status = PushStatus::CORRUPT;
+                return result;
+            }
+
+            // the current END is flagged with PENDING to prevent the consumer from taking data from the batch before all data is written;
+            // a consumer which points to this position will treat this like an overflow and look for the new END; like with 'publish',
+            // the OVERFLOW flag of the END is kept
+            auto firstOverflowFlag = static_cast<uint8_t>(stateAt(firstPosition).load(std::memory_order_relaxed) & OVERFLOW);
+            stateAt(firstPosition).store(static_cast<uint8_t>(PENDING | firstOverflowFlag), std::memory_order_relaxed);
+
+            auto currentPosition = firstPosition;
+            for (uint32_t i = 1; i < chunkSize; ++i) {
+                ++currentPosition;
+                if (currentPosition >= internalCapacity()) { currentPosition = 0; }
+                auto previousState = stateAt(currentPosition).exchange(PENDING, std::memory_order_relaxed);
+                if (previousState & DATA) {
+                    // the overrun position is flagged like a position the END was advanced over, which results in a DO state after the publish
+                    stateAt(currentPosition).fetch_or(OVERFLOW, std::memory_order_relaxed);
+                    countOverflow();
+                    overflowCallback(dataAt(currentPosition));
+                    result.status = PushStatus::OVERFLOWED;
+                }
+            }
+            if (resource.has_value()) {
+                overflowCallback(*resource);
+                result.status = PushStatus::OVERFLOWED;
+            }
+
+            currentPosition = firstPosition;
+            for (uint32_t i = 0; i < chunkSize; ++i) {
+                dataAt(currentPosition) = data[i];
+                ++currentPosition;
+                if (currentPosition >= internalCapacity()) { currentPosition = 0; }
+            }
 
+            // the fence pairs with the acquire load of a consumer which looks for the new END and ensures it cannot see a DATA flag from the
+            // batch without also seeing the PENDING flag at the first position
+            std::atomic_thread_fence(std::memory_order_release);
+
+            // the PENDING flags are reset in reverse order and the store to the first position publishes the whole batch; the OVERFLOW flags
+            // are kept
+            for (uint32_t i = chunkSize - 1; i > 0; --i) {
+                currentPosition = firstPosition + i;
+                if (currentPosition >= internalCapacity()) { currentPosition -= internalCapacity(); }
+                auto overflowFlag = static_cast<uint8_t>(stateAt(currentPosition).load(std::memory_order_relaxed) & OVERFLOW);
+                stateAt(currentPosition).store(static_cast<uint8_t>(DATA | overflowFlag), std::memory_order_relaxed);
+            }
+            stateAt(firstPosition).store(static_cast<uint8_t>(DATA | firstOverflowFlag), std::memory_order_release);
+            countPushes(chunkSize);
+
+            position = endPosition;
+            data += chunkSize;
+            count -= chunkSize;
+            result.pushed += chunkSize;
+        }
+        return result;
+    }
+
+    // advances the END flag to 'position' and takes the ownership of the data at this position in case of an overflow;
+    // returns false if the state is fishy
+    bool advanceEnd(uint32_t position, std::optional<T>& resource) {
+        bool overflow {false};
+        auto isEndAdvanced = advanceEnd(position, overflow);
+        if (overflow) { resource.emplace(dataAt(position)); }
+        return isEndAdvanced;
+    }
+
+    // same as above but only indicates the overflow; the overflowed data stays untouched at 'position' until it becomes the tail position
+    bool advanceEnd(uint32_t position, bool& overflow) {
         uint8_t newState      = END | OVERFLOW;
         uint8_t expectedState = DATA;
 
         constexpr bool KEEP_TRYING {true};
         do {
-            if (stateBuffer[nextPosition].compare_exchange_strong(expectedState, newState, std::memory_order_relaxed)) {
-                if (expectedState & DATA) { resource.emplace(dataBuffer[nextPosition]); }
-                break;
+            if (stateAt(position).compare_exchange_strong(expectedState, newState, std::memory_order_relaxed)) {
+                overflow = (expectedState & DATA) != 0;
+                if (overflow) { countOverflow(); }
+                return true;
             }
 
+            // the only END is at the current tail position; another one at the next position means the state is fishy
+            if (expectedState & END) { return false; }
+
             if (expectedState & DATA) {
                 newState = END | OVERFLOW;
             } else {
                 newState = END;
             }
         } while (KEEP_TRYING);
+    }
 
-        if (!(stateBuffer[nextPosition].load(std::memory_order_relaxed) & END)) {
-            // at this point the state at the next tail position should contain the END flag
-            // TODO use an expected to indicate a fishy state of the queue
-            resource.reset();
-            return resource;
-        }
+    // the OVERFLOW flag of the END is kept when the data is published, which results in a DO state; a consumer pointing to such a state
+    // knows that the data it expected at this position was overflowed
+    void publish(uint32_t position) {
+        auto overflowFlag = static_cast<uint8_t>(stateAt(position).load(std::memory_order_relaxed) & OVERFLOW);
+        stateAt(position).store(static_cast<uint8_t>(DATA | overflowFlag), std::memory_order_release);
+    }
 
-        dataBuffer[currentPosition] = data;
-        newState                    = stateBuffer[currentPosition].load(std::memory_order_relaxed);
-        newState                    = DATA;
-        stateBuffer[currentPosition].store(newState, std::memory_order_release);
+    // the position of the handle was reused when the END passed it after the push of the handle, i.e. after 'internalCapacity' pushes;
+    // inspected data is not canceled since the consumer might already copy it and would take the failed claim as overflow
+    bool cancel(const CancelHandle& handle, uint64_t generation) {
+        if (handle.generation >= generation || generation - handle.generation >= internalCapacity()) { return false; }
 
-        position = nextPosition;
-        return resource;
+        auto state = stateAt(handle.position).load(std::memory_order_relaxed);
+        if ((state & ~OVERFLOW) != DATA) { return false; }
+
+        // the OVERFLOW flag of a DO state is kept for a consumer pointing to this position; no data is published, therefore relaxed is sufficient
+        return stateAt(handle.position)
+            .compare_exchange_strong(state, static_cast<uint8_t>(CANCELED | (state & OVERFLOW)), std::memory_order_relaxed);
+    }
+
+    // there is only one producer, therefore a load and store is sufficient
+    void countOverflow() { overflowCounter.store(overflowCounter.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    // the statistics are single-writer counters as well; there is no ordering with the queue operations required
+    static void increment(std::atomic<uint64_t>& counter, uint64_t value) {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    void countPushes(uint64_t pushes) {
+        if constexpr (Statistics::ENABLED) { increment(pushCounter, pushes); }
+    }
+
+    void countPop() const {
+        if constexpr (Statistics::ENABLED) { increment(consumerCounters.pops, 1); }
+    }
+
+    void countPopRetries(uint64_t retries) const {
+        if constexpr (Statistics::ENABLED) {
+            if (retries > 0) { increment(consumerCounters.popRetries, retries); }
+        }
+    }
+
+    void countCasFailure() const {
+        if constexpr (Statistics::ENABLED) { increment(consumerCounters.casFailures, 1); }
     }
 
     // it is not nice to have this as const method but required to ensure the pop cannot mutate the data buffer ... let's pretend this works the same like
     // interior mutability with Rust atomics
     // TODO use tuple instead of out-parameter
-    std::optional<T> pop(uint32_t& position) const {
-        assert(position < InternalCapacity && "Position out of bounds");
+    std::optional<T> pop(uint32_t& position, Search& search) const { return pop_checked(position, search).data; }
 
-        // NOTE: don't return nullopt but always resource to make use of NRVO
-        std::optional<T> resource;
-        auto             currentPosition = position;
-        auto             nextPosition    = currentPosition + 1;
+    PopResult pop_checked(uint32_t& position, Search& search) const {
+        auto claim = [this](uint32_t claimPosition, uint8_t& expectedState, const T&) {
+            return stateAt(claimPosition).compare_exchange_strong(expectedState, EMPTY, std::memory_order_release, std::memory_order_acquire);
+        };
+        return pop_checked(position, claim, search);
+    }
+
+    // the 'claim' performs the transition of the state at the new head position from DATA to EMPTY and gets the data which will be returned
+    // on success; this is used to hook the transactions of the TransactionalRoQueT into the pop operation
+    template <typename Claim>
+    PopResult pop_checked(uint32_t& position, Claim& claim, Search& search) const {
+        assert(position < internalCapacity() && "Position out of bounds");
+
+        // NOTE: don't return a temporary but always result to make use of NRVO
+        PopResult result;
+        auto&     resource        = result.data;
+        auto      currentPosition = search.active ? search.position : position;
+        auto      nextPosition    = currentPosition + 1;
 
+        // the search for the new head visited this number of consecutive states which were already inspected by the consumer without being
+        // reset by the producer; after a whole wrap-around of such states there is no END anymore and the queue is corrupt
+        uint64_t inspectedInSearch {search.active ? search.inspected : 0};
+        bool     overflowDetected {search.active};
+        search.active = false;
+
+        // the budget limits the number of inspected positions, including the ones which were skipped by the scan for the END candidate
+        const uint64_t maxInspectedPositions {search.budget * internalCapacity()};
+        uint64_t       inspectedPositions {0};
         constexpr bool KEEP_TRYING {true};
         uint64_t       loopCounter {0};
         do {
             ++loopCounter;
-            if (loopCounter > 10000) {
-                // a pop operation should not be unsuccessful with so many attempts
-                // TODO better termination criteria, e.g. configurable number of wrap-arounds defined by the user
-                // TODO use an expected to indicate a fishy state of the queue
+            ++inspectedPositions;
+            if (inspectedPositions > maxInspectedPositions) {
+                // the next operation continues the search for the new head at the current position
+                search.position  = currentPosition;
+                search.inspected = inspectedInSearch;
+                search.active    = overflowDetected;
                 resource.reset();
-                return resource;
+                result.status = PopStatus::RETRY_BUDGET_EXHAUSTED;
+                countPopRetries(loopCounter - 2);
+                return result;
             }
 
-            if (nextPosition >= InternalCapacity) { nextPosition = 0; }
+            if (nextPosition >= internalCapacity()) { nextPosition = 0; }
 
-            auto stateNextPosition    = stateBuffer[nextPosition].load(std::memory_order_acquire);
-            auto stateCurrentPosition = stateBuffer[currentPosition].load(std::memory_order_acquire);
+            auto stateNextPosition    = stateAt(nextPosition).load(std::memory_order_acquire);
+            auto stateCurrentPosition = stateAt(currentPosition).load(std::memory_order_acquire);
 
             if ((stateCurrentPosition & EMPTY) && (stateNextPosition & (END | PENDING))) {
                 resource.reset();
                 // queue is empty
+                result.status = PopStatus::EMPTY;
                 break;
             }
 
+            inspectedInSearch = (stateNextPosition & INSPECTED) ? inspectedInSearch + 1 : 0;
+            if (inspectedInSearch > internalCapacity()) {
+                resource.reset();
+                result.status = PopStatus::CORRUPT;
+                countPopRetries(loopCounter - 1);
+                return result;
+            }
+
             // set the inspected flag to prevent the ABA problem on a wrap-around;
             // the inspected flag can only be set by the consumer and will be reset by the producer when new data is pushed
             if (!(stateNextPosition & INSPECTED)) {
                 auto expectedStateNextPosition = stateNextPosition;
                 stateNextPosition |= INSPECTED;
-                auto casSuccessful = stateBuffer[nextPosition].compare_exchange_strong(
+                auto casSuccessful = stateAt(nextPosition).compare_exchange_strong(
                     expectedStateNextPosition, stateNextPosition | INSPECTED, std::memory_order_release, std::memory_order_acquire);
-                if (!casSuccessful) { continue; }
+                if (!casSuccessful) {
+                    countCasFailure();
+                    continue;
+                }
             }
 
-            resource.emplace(dataBuffer[nextPosition]);
+            // the data of a canceled position is not copied since the position is skipped
+            const bool canceled = (stateNextPosition & CANCELED) != 0;
+            if (!canceled) { resource.emplace(dataAt(nextPosition)); }
 
-            stateCurrentPosition = stateBuffer[currentPosition].load(std::memory_order_seq_cst);
+            stateCurrentPosition = stateAt(currentPosition).load(std::memory_order_seq_cst);
             // TODO in theory the compare_exchange_strong with memory_order_release should have the same effect as the load with memory_order_seq_cst; further
             // investigations are needed to determine the performance impact and correctness
-            // stateBuffer[currentPosition].compare_exchange_strong(stateCurrentPosition, stateCurrentPosition,std::memory_order_release);
+            // stateAt(currentPosition).compare_exchange_strong(stateCurrentPosition, stateCurrentPosition,std::memory_order_release);
 
             if ((stateCurrentPosition & END) && (stateCurrentPosition & OVERFLOW)) {
-                stateBuffer[currentPosition].compare_exchange_strong(stateCurrentPosition, stateCurrentPosition & ~OVERFLOW, std::memory_order_release);
-            } else if (((stateCurrentPosition & EMPTY) || (stateCurrentPosition & END)) && (stateNextPosition & DATA)) {
-                auto newStateNextPosition = EMPTY;
-
-                auto popSuccessful = stateBuffer[nextPosition].compare_exchange_strong(
-                    stateNextPosition, newStateNextPosition, std::memory_order_release, std::memory_order_acquire);
+                stateAt(currentPosition).compare_exchange_strong(stateCurrentPosition, stateCurrentPosition & ~OVERFLOW, std::memory_order_release);
+                overflowDetected = true;
+            } else if (((stateCurrentPosition & EMPTY) || (stateCurrentPosition & END)) && (stateNextPosition & (DATA | CANCELED))) {
+                auto popSuccessful = canceled ? skip(nextPosition, stateNextPosition) : claim(nextPosition, stateNextPosition, *resource);
                 if (!popSuccessful) {
                     // find new END
+                    countCasFailure();
+                    currentPosition  = nextPosition;
+                    overflowDetected = true;
+                    ++nextPosition;
+                } else if (canceled) {
+                    // the head position is moved behind the canceled position and the next position is inspected
+                    position        = nextPosition;
                     currentPosition = nextPosition;
                     ++nextPosition;
                 } else {
                     position = nextPosition;
-                    if ((stateCurrentPosition & END) && (stateCurrentPosition & OVERFLOW)) {
-                        // TODO inform the user about the overflow, e.g. by setting a flag or via return value
+                    if (overflowDetected) {
+                        result.status = PopStatus::OVERFLOW_RECOVERED;
+                        result.lost   = lostSinceLastReport(search);
+                    } else {
+                        result.status = PopStatus::DATA;
                     }
+                    countPop();
                     break;
                 }
             } else {
-                // there was an overflow and we need to find the new head
-                currentPosition = nextPosition;
-                ++nextPosition;
+                // there was an overflow and we need to find the new head; the search continues at the next END candidate
+                auto endCandidate = nextEndCandidate(currentPosition, nextPosition);
+                inspectedPositions += distance(nextPosition, endCandidate);
+                currentPosition  = endCandidate;
+                overflowDetected = true;
+                nextPosition     = currentPosition + 1;
+            }
+        } while (KEEP_TRYING);
+
+        countPopRetries(loopCounter - 1);
+        return result;
+    }
+
+    // the producer counts the overflow before it publishes the next data, therefore the sum of the reported lost elements is exact although
+    // an overflow might be reported with the previous or next recovery
+    uint64_t lostSinceLastReport(Search& search) const {
+        auto overflows           = overflowCounter.load(std::memory_order_acquire);
+        auto lost                = overflows - search.reportedOverflows;
+        search.reportedOverflows = overflows;
+        return lost;
+    }
+
+    // the transition of a canceled position to EMPTY like the claim of data
+    bool skip(uint32_t position, uint8_t& expectedState) const {
+        return stateAt(position).compare_exchange_strong(expectedState, EMPTY, std::memory_order_release, std::memory_order_acquire);
+    }
+
+    // searches the data like 'pop' and sets the INSPECTED flag but leaves the copy of the data and the claim to the user and 'release';
+    // canceled positions are skipped and move the head position
+    std::optional<Borrow> borrow(uint32_t& position, Search& search) const {
+        assert(position < internalCapacity() && "Position out of bounds");
+
+        std::optional<Borrow> borrow;
+        auto                  currentPosition = search.active ? search.position : position;
+        auto                  nextPosition    = currentPosition + 1;
+
+        // the search state is shared with 'pop_checked', therefore the inspected states are counted for its corruption detection as well
+        uint64_t inspectedInSearch {search.active ? search.inspected : 0};
+        bool     overflowDetected {search.active};
+        search.active = false;
+
+        const uint64_t maxInspectedPositions {search.budget * internalCapacity()};
+        uint64_t       inspectedPositions {0};
+        constexpr bool KEEP_TRYING {true};
+        do {
+            ++inspectedPositions;
+            // a corrupted queue is not searched any further and reported by the next 'pop_checked'
+            if (inspectedPositions > maxInspectedPositions || inspectedInSearch > internalCapacity()) {
+                // the next operation continues the search for the new head at the current position
+                search.position  = currentPosition;
+                search.inspected = inspectedInSearch;
+                search.active    = overflowDetected;
+                return borrow;
+            }
+
+            if (nextPosition >= internalCapacity()) { nextPosition = 0; }
+
+            auto stateNextPosition    = stateAt(nextPosition).load(std::memory_order_acquire);
+            auto stateCurrentPosition = stateAt(currentPosition).load(std::memory_order_acquire);
+
+            if ((stateCurrentPosition & EMPTY) && (stateNextPosition & (END | PENDING))) {
+                // queue is empty
+                break;
+            }
+
+            inspectedInSearch = (stateNextPosition & INSPECTED) ? inspectedInSearch + 1 : 0;
+
+            if (!(stateNextPosition & INSPECTED)) {
+                auto expectedStateNextPosition = stateNextPosition;
+                stateNextPosition |= INSPECTED;
+                auto casSuccessful = stateAt(nextPosition).compare_exchange_strong(
+                    expectedStateNextPosition, stateNextPosition, std::memory_order_release, std::memory_order_acquire);
+                if (!casSuccessful) { continue; }
+            }
+
+            if ((stateCurrentPosition & END) && (stateCurrentPosition & OVERFLOW)) {
+                stateAt(currentPosition).compare_exchange_strong(stateCurrentPosition, stateCurrentPosition & ~OVERFLOW, std::memory_order_release);
+                overflowDetected = true;
+            } else if (((stateCurrentPosition & EMPTY) || (stateCurrentPosition & END)) && (stateNextPosition & DATA)) {
+                borrow.emplace(Borrow(&dataAt(nextPosition), currentPosition, nextPosition, stateNextPosition));
+                if (overflowDetected) {
+                    borrow->popStatus    = PopStatus::OVERFLOW_RECOVERED;
+                    borrow->lostElements = lostSinceLastReport(search);
+                }
+                break;
+            } else if (((stateCurrentPosition & EMPTY) || (stateCurrentPosition & END)) && (stateNextPosition & CANCELED)) {
+                // the checks of 'release' are done right away since there is no data to hand out; on failure the states are loaded again
+                stateCurrentPosition = stateAt(currentPosition).load(std::memory_order_seq_cst);
+                auto currentIsValid  = (stateCurrentPosition & EMPTY) || ((stateCurrentPosition & END) && !(stateCurrentPosition & OVERFLOW));
+                if (currentIsValid && skip(nextPosition, stateNextPosition)) {
+                    position        = nextPosition;
+                    currentPosition = nextPosition;
+                    ++nextPosition;
+                }
+            } else {
+                // there was an overflow and we need to find the new head; the search continues at the next END candidate
+                auto endCandidate = nextEndCandidate(currentPosition, nextPosition);
+                inspectedPositions += distance(nextPosition, endCandidate);
+                currentPosition  = endCandidate;
+                overflowDetected = true;
+                nextPosition     = currentPosition + 1;
             }
         } while (KEEP_TRYING);
 
+        return borrow;
+    }
+
+    // performs the checks and the claim of 'pop' after the data was read in place; on failure the head position is not changed and the
+    // next 'borrow' searches the new head and reports the overflow, since the OVERFLOW flag might already be reset by this 'release'
+    bool release(Borrow& borrow, uint32_t& position, Search& search) const {
+        assert(borrow.data != nullptr && "The borrow was already released");
+        borrow.data = nullptr;
+
+        auto stateCurrentPosition = stateAt(borrow.currentPosition).load(std::memory_order_seq_cst);
+        if ((stateCurrentPosition & END) && (stateCurrentPosition & OVERFLOW)) {
+            stateAt(borrow.currentPosition)
+                .compare_exchange_strong(stateCurrentPosition, stateCurrentPosition & ~OVERFLOW, std::memory_order_release);
+        } else if (stateCurrentPosition & (EMPTY | END)) {
+            auto stateNextPosition = borrow.stateNextPosition;
+            if (stateAt(borrow.nextPosition).compare_exchange_strong(stateNextPosition, EMPTY, std::memory_order_release, std::memory_order_acquire)) {
+                position = borrow.nextPosition;
+                countPop();
+                return true;
+            }
+        }
+
+        // the next operation searches the new head like after a detected overflow
+        search.position  = position;
+        search.inspected = 0;
+        search.active    = true;
+        return false;
+    }
+
+    // the number of 'pop' attempts before the consumer goes to sleep
+    static constexpr uint32_t WAIT_SPIN_COUNT {100};
+
+    std::optional<T> pop_wait(uint32_t& position, Search& search, std::chrono::nanoseconds timeout) const {
+        static_assert(Blocking, "The blocking pop is only available with 'Blocking' enabled");
+
+        auto resource = pop(position, search);
+        for (uint32_t i = 1; i < WAIT_SPIN_COUNT && !resource.has_value(); ++i) {
+            resource = pop(position, search);
+        }
+
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (!resource.has_value()) {
+            auto remainingTime = deadline - std::chrono::steady_clock::now();
+            if (remainingTime <= std::chrono::nanoseconds::zero()) { break; }
+
+            // the wake-up counter is loaded before the queue is checked again, therefore a push after the check changes the counter and
+            // the futex does not sleep; the fence pairs with the fence in 'notify' and ensures that either the consumer sees the data or the
+            // producer sees the waiter
+            auto wakeUpCounter = waitState.wakeUpCounter.load(std::memory_order_acquire);
+            waitState.numberOfWaiters.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            resource = pop(position, search);
+            if (!resource.has_value()) {
+                futexWait(waitState.wakeUpCounter, wakeUpCounter, std::chrono::duration_cast<std::chrono::nanoseconds>(remainingTime));
+                resource = pop(position, search);
+            }
+
+            waitState.numberOfWaiters.fetch_sub(1, std::memory_order_relaxed);
+        }
+
         return resource;
     }
 
+    // wakes up the consumer if it is waiting; the syscall is only done when the consumer registered as waiter and without blocking pop
+    // nothing is done at all
+    void notify() {
+        if constexpr (Blocking) {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (waitState.numberOfWaiters.load(std::memory_order_relaxed) == 0) { return; }
+
+            waitState.wakeUpCounter.fetch_add(1, std::memory_order_release);
+            futexWake(waitState.wakeUpCounter);
+        }
+    }
+
+    // the futex is not private to the process since the RoQueT might be placed in shared memory
+    static void futexWait(std::atomic<uint32_t>& futex, uint32_t expected, std::chrono::nanoseconds timeout) {
+        auto seconds  = std::chrono::duration_cast<std::chrono::seconds>(timeout);
+        auto timeSpec = timespec {static_cast<time_t>(seconds.count()), static_cast<long>((timeout - seconds).count())};
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&futex), FUTEX_WAIT, expected, &timeSpec, nullptr, 0);
+    }
+
+    static void futexWake(std::atomic<uint32_t>& futex) {
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&futex), FUTEX_WAKE, 1, nullptr, nullptr, 0);
+    }
+
+    enum class RunResult { QUEUE_EMPTY, RUN_INTERRUPTED, MAX_REACHED };
+
+    // pops consecutive elements and passes them to 'f'; the first element of a run takes the regular 'pop' path which also performs a potential
+    // overflow recovery and the remaining elements are taken by 'pop_run_continuation' as long as the producer does not interfere
+    template <typename F>
+    uint64_t pop_run(F& f, uint64_t max, uint32_t& position, Search& search) const {
+        uint64_t count {0};
+        while (count < max) {
+            auto resource = pop(position, search);
+            if (!resource.has_value()) { break; }
+            f(*resource);
+            ++count;
+
+            if (pop_run_continuation(f, max, count, position) == RunResult::QUEUE_EMPTY) { break; }
+        }
+        return count;
+    }
+
+    // the state at 'position' was set to EMPTY by the consumer itself, therefore it is not loaded before the next position is inspected;
+    // the INSPECTED flag is set with a speculative CAS expecting a plain DATA state, which also replaces the acquire load of the next position
+    template <typename F>
+    RunResult pop_run_continuation(F& f, uint64_t max, uint64_t& count, uint32_t& position) const {
+        auto currentPosition = position;
+        while (count < max) {
+            auto nextPosition = currentPosition + 1;
+            if (nextPosition >= internalCapacity()) { nextPosition = 0; }
+
+            uint8_t stateNextPosition = DATA;
+            if (!stateAt(nextPosition).compare_exchange_strong(
+                    stateNextPosition, DATA | INSPECTED, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                // a canceled position is skipped by the regular 'pop'
+                if (stateNextPosition & CANCELED) { return RunResult::RUN_INTERRUPTED; }
+                if (!(stateNextPosition & DATA)) { return RunResult::QUEUE_EMPTY; }
+                if (!(stateNextPosition & INSPECTED)) { return RunResult::RUN_INTERRUPTED; }
+            } else {
+                stateNextPosition = DATA | INSPECTED;
+            }
+
+            T data = dataAt(nextPosition);
+
+            // if the producer overwrote the next position before the INSPECTED flag was set, it also overwrote the current position;
+            // the acquire semantics of the CAS above ensure this is visible
+            auto stateCurrentPosition = stateAt(currentPosition).load(std::memory_order_relaxed);
+            auto currentIsValid       = (stateCurrentPosition & EMPTY) || ((stateCurrentPosition & END) && !(stateCurrentPosition & OVERFLOW));
+            if (!currentIsValid) { return RunResult::RUN_INTERRUPTED; }
+
+            if (!stateAt(nextPosition).compare_exchange_strong(stateNextPosition, EMPTY, std::memory_order_release, std::memory_order_relaxed)) {
+                return RunResult::RUN_INTERRUPTED;
+            }
+
+            position        = nextPosition;
+            currentPosition = nextPosition;
+            countPop();
+            f(data);
+            ++count;
+        }
+        return RunResult::MAX_REACHED;
+    }
+
+    void init() {
+        for (uint32_t i = 0; i < internalCapacity(); ++i) {
+            stateAt(i).store(EMPTY, std::memory_order_relaxed);
+        }
+        stateAt(1).store(END, std::memory_order_relaxed);
+    }
+
+    // the positions are 32 bit values, therefore the internal capacity is as well
+    uint32_t internalCapacity() const {
+        if constexpr (Capacity == DYNAMIC_CAPACITY) {
+            return static_cast<uint32_t>(storage.capacity);
+        } else {
+            return static_cast<uint32_t>(InternalCapacity);
+        }
+    }
+
+    // scans the states behind 'position' for the END; the precise checks of the search are only done at the candidate instead of each
+    // position in between; returns 'nextPosition' if there is no candidate, e.g. since the producer is just advancing the END
+    uint32_t nextEndCandidate(uint32_t position, uint32_t nextPosition) const {
+        auto candidate = storage.find(position + 1U, internalCapacity(), END);
+        if (candidate == internalCapacity()) {
+            candidate = storage.find(0, position, END);
+            if (candidate == position) { return nextPosition; }
+        }
+        return static_cast<uint32_t>(candidate);
+    }
+
+    // the number of positions from 'from' to 'to' in push direction
+    uint32_t distance(uint32_t from, uint32_t to) const { return to >= from ? to - from : to + internalCapacity() - from; }
+
+    std::atomic<uint8_t>& stateAt(uint32_t position) const { return storage.state(position); }
+    T&                    dataAt(uint32_t position) { return storage.data(position); }
+    const T&              dataAt(uint32_t position) const { return storage.data(position); }
+
 private:
-    mutable std::atomic<uint8_t> stateBuffer[InternalCapacity];
-    // this could also be placed at a location where the consumer has no write access
-    T dataBuffer[InternalCapacity];
+    // the state buffer and the data buffer; the data buffer could also be placed at a location where the consumer has no write access
+    std::conditional_t<Capacity == DYNAMIC_CAPACITY,
+                       typename Layout::template DynamicStorage<T>,
+                       typename Layout::template Storage<T, InternalCapacity>>
+        storage;
+
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t) && std::atomic<uint32_t>::is_always_lock_free,
+                  "The wake-up counter is used as futex");
+
+    // placeholder for the optional members; each member has its own type to not require distinct addresses
+    template <uint32_t>
+    struct NoCounter {};
+
+    // the wait state is placed on its own cache line since the producer checks for waiters on each push; it only exists with blocking pop
+    struct alignas(CACHE_LINE_SIZE) WaitState {
+        std::atomic<uint32_t> wakeUpCounter {0};
+        std::atomic<uint32_t> numberOfWaiters {0};
+    };
+    [[no_unique_address]] mutable std::conditional_t<Blocking, WaitState, NoCounter<2>> waitState {};
+
+    // the number of overflowed elements; only written by the producer and read by the consumer when it detected an overflow
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> overflowCounter {0};
+
+    // the push counter shares the cache line with the overflow counter, which is written by the producer anyway
+    [[no_unique_address]] std::conditional_t<Statistics::ENABLED, std::atomic<uint64_t>, NoCounter<0>> pushCounter {};
+
+    // the counters of the consumer are placed on their own cache line to not introduce false sharing with the producer
+    struct alignas(CACHE_LINE_SIZE) ConsumerCounters {
+        std::atomic<uint64_t> pops {0};
+        std::atomic<uint64_t> popRetries {0};
+        std::atomic<uint64_t> casFailures {0};
+    };
+    [[no_unique_address]] mutable std::conditional_t<Statistics::ENABLED, ConsumerCounters, NoCounter<1>> consumerCounters {};
     // tailPosition could be buffered here instead of in the 'Producer' to enable crash recovery
 };
 
@@ -0,0 +1,150 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// SPDX-FileCopyrightText: © 2023 Mathias Kraus <elboberido@m-hias.de>
+
+#ifndef _SHARED_ROQUET_HPP_
+#define _SHARED_ROQUET_HPP_
+
+#include "event_notifier.hpp"
+#include "roquet.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <new>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Placement of a RoQueT in a POSIX shared memory segment
+//
+// The segment starts with a header which is followed by the RoQueT. The header contains a magic value, a version and the parameters of the
+// RoQueT in order to detect a mismatch between the processes. The magic value is written last with release semantics and therefore also
+// indicates that the RoQueT is fully constructed.
+// The 'Producer' and 'Consumer' obtained from the RoQueT keep their positions in the process local memory, therefore each of them must
+// be attached only once during the lifetime of the segment. The TransactionalRoQueT can be used as 'Queue' to keep the positions in the
+// segment as well and to be able to recover from crashes.
+// The header also contains the state of an 'EventNotifier' to drive the consumer by an event loop.
+template <typename T, uint64_t Capacity, typename Layout = PackedLayout, typename Queue = RoQueT<T, Capacity, Layout>>
+class SharedRoQueT {
+public:
+    static_assert(std::atomic<uint8_t>::is_always_lock_free, "The states must be lock-free to be shared between processes");
+    static_assert(Capacity != DYNAMIC_CAPACITY, "The segment size of the SharedRoQueT is determined at compile time");
+
+    static constexpr uint64_t MAGIC {0x526F51756554'0000}; // "RoQueT"
+    static constexpr uint32_t VERSION {7};
+
+    struct Header {
+        std::atomic<uint64_t> magic;
+        uint32_t              version;
+        uint32_t              queueOffset;
+        uint64_t              capacity;
+        uint64_t              dataSize;
+        uint64_t              queueSize;
+        EventNotifier::State  notifierState;
+    };
+
+    static constexpr uint32_t QUEUE_OFFSET {(sizeof(Header) + alignof(Queue) - 1) / alignof(Queue) * alignof(Queue)};
+    static constexpr uint64_t SEGMENT_SIZE {QUEUE_OFFSET + sizeof(Queue)};
+
+    // creates the segment with the 'name' and constructs the RoQueT in it; fails if the segment already exists
+    static std::optional<SharedRoQueT> create(const std::string& name) {
+        std::optional<SharedRoQueT> shared;
+
+        auto fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+        if (fd == -1) { return shared; }
+
+        if (ftruncate(fd, static_cast<off_t>(SEGMENT_SIZE)) == -1) {
+            close(fd);
+            shm_unlink(name.c_str());
+            return shared;
+        }
+
+        auto memory = mmap(nullptr, SEGMENT_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (memory == MAP_FAILED) {
+            shm_unlink(name.c_str());
+            return shared;
+        }
+
+        auto header = new (memory) Header;
+        header->magic.store(0, std::memory_order_relaxed);
+        header->version     = VERSION;
+        header->queueOffset = QUEUE_OFFSET;
+        header->capacity    = Capacity;
+        header->dataSize    = sizeof(T);
+        header->queueSize   = sizeof(Queue);
+        new (static_cast<uint8_t*>(memory) + QUEUE_OFFSET) Queue;
+        header->magic.store(MAGIC, std::memory_order_release);
+
+        shared.emplace(SharedRoQueT(name, memory, true));
+        return shared;
+    }
+
+    // opens the segment with the 'name'; fails if the segment does not exist, is not yet initialized or does not match the RoQueT
+    static std::optional<SharedRoQueT> open(const std::string& name) {
+        std::optional<SharedRoQueT> shared;
+
+        auto fd = shm_open(name.c_str(), O_RDWR, 0);
+        if (fd == -1) { return shared; }
+
+        struct stat fileStatus;
+        if (fstat(fd, &fileStatus) == -1 || static_cast<uint64_t>(fileStatus.st_size) != SEGMENT_SIZE) {
+            close(fd);
+            return shared;
+        }
+
+        auto memory = mmap(nullptr, SEGMENT_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (memory == MAP_FAILED) { return shared; }
+
+        auto header = static_cast<Header*>(memory);
+        if (header->magic.load(std::memory_order_acquire) != MAGIC || header->version != VERSION || header->queueOffset != QUEUE_OFFSET
+            || header->capacity != Capacity || header->dataSize != sizeof(T) || header->queueSize != sizeof(Queue)) {
+            munmap(memory, SEGMENT_SIZE);
+            return shared;
+        }
+
+        shared.emplace(SharedRoQueT(name, memory, false));
+        return shared;
+    }
+
+    // removes a segment, e.g. a stale one from a crashed process
+    static bool remove(const std::string& name) { return shm_unlink(name.c_str()) == 0; }
+
+    SharedRoQueT(const SharedRoQueT&) = delete;
+    SharedRoQueT(SharedRoQueT&& rhs) noexcept
+        : name(std::move(rhs.name))
+        , memory(std::exchange(rhs.memory, nullptr))
+        , owner(std::exchange(rhs.owner, false)) {}
+
+    SharedRoQueT& operator=(const SharedRoQueT&) = delete;
+    SharedRoQueT& operator=(SharedRoQueT&&)      = delete;
+
+    // the creator unlinks the segment; processes which already opened it can continue to use it
+    ~SharedRoQueT() {
+        if (memory != nullptr) { munmap(memory, SEGMENT_SIZE); }
+        if (owner) { shm_unlink(name.c_str()); }
+    }
+
+    Queue& roquet() { return *reinterpret_cast<Queue*>(static_cast<uint8_t*>(memory) + QUEUE_OFFSET); }
+
+    // the state for 'EventNotifier::create' by the consumer and 'EventNotifier::open' by the producer
+    EventNotifier::State& notifier_state() { return static_cast<Header*>(memory)->notifierState; }
+
+private:
+    SharedRoQueT(const std::string& n, void* m, bool o)
+        : name(n)
+        , memory(m)
+        , owner(o) {}
+
+private:
+    std::string name;
+    void*       memory {nullptr};
+    bool        owner {false};
+};
+
+#endif // _SHARED_ROQUET_HPP_
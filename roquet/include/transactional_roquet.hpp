@@ -0,0 +1,253 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// SPDX-FileCopyrightText: © 2023 Mathias Kraus <elboberido@m-hias.de>
+
+#ifndef _TRANSACTIONAL_ROQUET_HPP_
+#define _TRANSACTIONAL_ROQUET_HPP_
+
+#include "roquet.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <optional>
+
+// Transactional Robust Queue Transfer
+//
+// Opt-in crash recoverable variant of the RoQueT. The head and tail positions are not kept in the 'Producer' and 'Consumer' but alongside
+// the RoQueT in a transaction record for each side. When the TransactionalRoQueT is placed in a shared memory segment, e.g. with the
+// SharedRoQueT, a restarted process can attach a new 'Producer' or 'Consumer' and call 'recover' to finish or roll back the operation which
+// was interrupted by the crash. 'recover' returns the data whose ownership would otherwise be lost, i.e. the overflowed data of an interrupted
+// push or the data of an interrupted pop which was already claimed from the queue.
+//
+// The ownership of the data is unambiguous at each step:
+// - push: only the producer sets the END flag, therefore END at the next position means the advance succeeded; the state which was
+//   replaced by the CAS is persisted before each attempt and tells whether the advance caused an overflow; the data is published with a CAS
+//   which only succeeds as long as the current position still contains END
+// - pop: the consumer claims the data with a CAS from DATA to EMPTY | CLAIMED; the producer preserves the CLAIMED flag until the consumer
+//   persisted the new head position and cleared the flag, therefore the flag tells whether the claim succeeded
+// The recovery must not run concurrently to an operation on the same side of the queue.
+template <typename T, uint64_t Capacity, typename Layout = PackedLayout>
+class TransactionalRoQueT {
+public:
+    using Queue     = RoQueT<T, Capacity, Layout>;
+    using PopResult = typename Queue::PopResult;
+
+    static_assert(std::atomic<uint32_t>::is_always_lock_free, "The transaction records must be lock-free to be shared between processes");
+    static_assert(Capacity != DYNAMIC_CAPACITY, "The TransactionalRoQueT requires a capacity which is known at compile time");
+
+    enum class PushStep : uint8_t { IDLE, ADVANCE_END, PUBLISH_DATA };
+    enum class PopStep : uint8_t { IDLE, CLAIMING, CLAIMED };
+
+    struct PushTransaction {
+        std::atomic<uint32_t> tailPosition {1};
+        std::atomic<PushStep> step {PushStep::IDLE};
+        std::atomic<uint8_t>  replacedState {0};
+        uint32_t              position {0};
+        T                     data;
+    };
+
+    struct PopTransaction {
+        std::atomic<uint32_t> headPosition {0};
+        std::atomic<PopStep>  step {PopStep::IDLE};
+        uint32_t              position {0};
+        // the value of the overflow counter at the last reported overflow
+        uint64_t reportedOverflows {0};
+        T        data;
+    };
+
+    TransactionalRoQueT() = default;
+
+    TransactionalRoQueT(const TransactionalRoQueT&) = delete;
+    TransactionalRoQueT(TransactionalRoQueT&&)      = delete;
+
+    TransactionalRoQueT& operator=(const TransactionalRoQueT&) = delete;
+    TransactionalRoQueT& operator=(TransactionalRoQueT&&)      = delete;
+
+private:
+    class Producer {
+    public:
+        std::optional<T> push(const T& data) { return roquet.push(data); }
+
+        // finishes an interrupted push and returns the data which overflowed by it
+        std::optional<T> recover() { return roquet.recoverPush(); }
+
+        bool empty() { return roquet.queue.emptyForProducer(roquet.pushTransaction.tailPosition.load(std::memory_order_relaxed)); }
+
+        friend class TransactionalRoQueT;
+
+    private:
+        Producer(TransactionalRoQueT& r)
+            : roquet(r) {}
+
+    private:
+        TransactionalRoQueT& roquet;
+    };
+
+    class Consumer {
+    public:
+        std::optional<T> pop() { return roquet.pop_checked().data; }
+
+        // like 'pop' but also reports the number of elements which were lost by an overflow
+        PopResult pop_checked() { return roquet.pop_checked(); }
+
+        // finishes an interrupted pop which already claimed the data and returns this data; a pop which did not yet claim the data is rolled back
+        std::optional<T> recover() { return roquet.recoverPop(); }
+
+        bool empty() { return roquet.queue.emptyForConsumer(roquet.popTransaction.headPosition.load(std::memory_order_relaxed)); }
+
+        friend class TransactionalRoQueT;
+
+    private:
+        Consumer(TransactionalRoQueT& r)
+            : roquet(r) {}
+
+    private:
+        TransactionalRoQueT& roquet;
+    };
+
+public:
+    // since the positions are stored in the transaction records, a 'Producer' and a 'Consumer' can be attached again after a crash;
+    // there must not be more than one of each at the same time
+    Producer producer() { return Producer(*this); }
+    Consumer consumer() { return Consumer(*this); }
+
+    // the transaction records can be inspected e.g. by a supervisor which needs to decide whether a recovery is required
+    const PushTransaction& pushTransactionRecord() const { return pushTransaction; }
+    const PopTransaction&  popTransactionRecord() const { return popTransaction; }
+
+private:
+    static constexpr uint8_t EMPTY {Queue::EMPTY};
+    static constexpr uint8_t DATA {Queue::DATA};
+    static constexpr uint8_t OVERFLOW {Queue::OVERFLOW};
+    static constexpr uint8_t CLAIMED {Queue::CLAIMED};
+    static constexpr uint8_t END {Queue::END};
+
+    static uint32_t next(uint32_t position) { return position + 1 >= Queue::InternalCapacity ? 0 : position + 1; }
+
+    std::optional<T> push(const T& data) {
+        auto& transaction = pushTransaction;
+
+        transaction.data     = data;
+        transaction.position = transaction.tailPosition.load(std::memory_order_relaxed);
+        transaction.replacedState.store(DATA, std::memory_order_relaxed);
+        transaction.step.store(PushStep::ADVANCE_END, std::memory_order_release);
+
+        return finishPush();
+    }
+
+    std::optional<T> recoverPush() {
+        std::optional<T> resource;
+        if (pushTransaction.step.load(std::memory_order_acquire) != PushStep::IDLE) { resource = finishPush(); }
+        return resource;
+    }
+
+    // continues the push transaction at the persisted step; each step can be repeated without changing the outcome
+    std::optional<T> finishPush() {
+        // NOTE: don't return nullopt but always resource to make use of NRVO
+        std::optional<T> resource;
+        auto&            transaction     = pushTransaction;
+        auto             currentPosition = transaction.position;
+        auto             nextPosition    = next(currentPosition);
+
+        if (transaction.step.load(std::memory_order_relaxed) == PushStep::ADVANCE_END) {
+            auto& state = queue.stateAt(nextPosition);
+            // the END flag is only set by the producer, if it is already there the CAS succeeded before the crash
+            if (!(state.load(std::memory_order_relaxed) & END)) {
+                auto expectedState = transaction.replacedState.load(std::memory_order_relaxed);
+
+                constexpr bool KEEP_TRYING {true};
+                do {
+                    transaction.replacedState.store(expectedState, std::memory_order_relaxed);
+                    uint8_t newState = (expectedState & DATA) ? END | OVERFLOW : END;
+                    newState |= expectedState & CLAIMED;
+                    if (state.compare_exchange_strong(expectedState, newState, std::memory_order_relaxed)) {
+                        if (expectedState & DATA) { queue.countOverflow(); }
+                        break;
+                    }
+                } while (KEEP_TRYING);
+            }
+            transaction.step.store(PushStep::PUBLISH_DATA, std::memory_order_release);
+        }
+
+        // the overflowed data stays untouched at the next position until the following push
+        if (transaction.replacedState.load(std::memory_order_relaxed) & DATA) { resource.emplace(queue.dataAt(nextPosition)); }
+
+        auto& state        = queue.stateAt(currentPosition);
+        auto  currentState = state.load(std::memory_order_relaxed);
+        if (currentState & END) {
+            // the data was not yet published; the consumer might only have changed the OVERFLOW and CLAIMED flags in the meantime; like with
+            // 'RoQueT::publish', the OVERFLOW flag is kept for a consumer pointing to this position
+            queue.dataAt(currentPosition) = transaction.data;
+            while (!state.compare_exchange_weak(
+                currentState, DATA | (currentState & (OVERFLOW | CLAIMED)), std::memory_order_release, std::memory_order_relaxed)) {}
+        }
+
+        transaction.tailPosition.store(nextPosition, std::memory_order_relaxed);
+        transaction.step.store(PushStep::IDLE, std::memory_order_release);
+
+        return resource;
+    }
+
+    PopResult pop_checked() {
+        auto& transaction = popTransaction;
+
+        auto claim = [this, &transaction](uint32_t claimPosition, uint8_t& expectedState, const T& data) {
+            transaction.data     = data;
+            transaction.position = claimPosition;
+            transaction.step.store(PopStep::CLAIMING, std::memory_order_release);
+
+            auto claimed = queue.stateAt(claimPosition)
+                               .compare_exchange_strong(expectedState, EMPTY | CLAIMED, std::memory_order_release, std::memory_order_acquire);
+            transaction.step.store(claimed ? PopStep::CLAIMED : PopStep::IDLE, std::memory_order_release);
+            return claimed;
+        };
+
+        typename Queue::Search search;
+        search.reportedOverflows = transaction.reportedOverflows;
+
+        auto position = transaction.headPosition.load(std::memory_order_relaxed);
+        auto result   = queue.pop_checked(position, claim, search);
+        if (transaction.step.load(std::memory_order_relaxed) == PopStep::CLAIMED) {
+            transaction.reportedOverflows = search.reportedOverflows;
+            finishPop();
+        }
+
+        return result;
+    }
+
+    std::optional<T> recoverPop() {
+        // NOTE: don't return nullopt but always resource to make use of NRVO
+        std::optional<T> resource;
+        auto&            transaction = popTransaction;
+
+        auto step = transaction.step.load(std::memory_order_acquire);
+        if (step == PopStep::CLAIMING) {
+            // the producer preserves the CLAIMED flag, therefore it tells whether the CAS succeeded before the crash
+            if (queue.stateAt(transaction.position).load(std::memory_order_acquire) & CLAIMED) {
+                step = PopStep::CLAIMED;
+            } else {
+                transaction.step.store(PopStep::IDLE, std::memory_order_release);
+            }
+        }
+
+        if (step == PopStep::CLAIMED) {
+            resource.emplace(transaction.data);
+            finishPop();
+        }
+
+        return resource;
+    }
+
+    void finishPop() {
+        auto& transaction = popTransaction;
+        transaction.headPosition.store(transaction.position, std::memory_order_relaxed);
+        queue.stateAt(transaction.position).fetch_and(static_cast<uint8_t>(~CLAIMED), std::memory_order_release);
+        transaction.step.store(PopStep::IDLE, std::memory_order_release);
+    }
+
+private:
+    Queue           queue;
+    PushTransaction pushTransaction;
+    PopTransaction  popTransaction;
+};
+
+#endif // _TRANSACTIONAL_ROQUET_HPP_
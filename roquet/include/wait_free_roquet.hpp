@@ -0,0 +1,231 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// SPDX-FileCopyrightText: © 2023 Mathias Kraus <elboberido@m-hias.de>
+
+#ifndef _WAIT_FREE_ROQUET_HPP_
+#define _WAIT_FREE_ROQUET_HPP_
+
+#include "roquet.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <optional>
+
+// Wait-free Robust Queue Transfer
+//
+// Variant of the RoQueT whose pop does not search for the new head after an overflow but takes the overflowed data from an exchange
+// transaction, like the BuRiTTO does. Each element carries a consecutive counter which is stored alongside the data and determines its
+// position in the buffer. When the producer overflows an element, it parks the element in its transaction and exchanges it with the pending
+// transaction. The ownership of the element which it gets back from the exchange is transferred to the user unless it was already taken by
+// the consumer. This means the push returns the data of the previous overflow and the most recently overflowed element stays in the pending
+// transaction until it is either taken by the consumer or returned by the next overflow.
+// The consumer takes the next element with the INSPECTED and EMPTY CAS operations of the RoQueT as long as the counter matches the one it
+// expects. If this fails, it exchanges its transaction with the pending one, which contains the counter of the element it wants to take.
+// If it gets a parked element which is newer than the last popped one, it takes this element and continues behind it. Otherwise the producer
+// did not yet park the expected element and since the producer overwrites the data only after the exchange, the copy of the consumer is
+// still valid. The pop has therefore no loop and a hard upper bound of two CAS operations and one exchange.
+template <typename T, uint64_t Capacity, typename Layout = PackedLayout>
+class WaitFreeRoQueT {
+private:
+    struct Element {
+        T        value;
+        uint64_t counter;
+    };
+
+public:
+    using Queue = RoQueT<Element, Capacity, Layout>;
+
+    static_assert(Capacity != DYNAMIC_CAPACITY, "The WaitFreeRoQueT requires a capacity which is known at compile time");
+
+    WaitFreeRoQueT() = default;
+
+    WaitFreeRoQueT(const WaitFreeRoQueT&) = delete;
+    WaitFreeRoQueT(WaitFreeRoQueT&&)      = delete;
+
+    WaitFreeRoQueT& operator=(const WaitFreeRoQueT&) = delete;
+    WaitFreeRoQueT& operator=(WaitFreeRoQueT&&)      = delete;
+
+private:
+    enum class TaSource { POP, PUSH };
+
+    struct Transaction {
+        T        value;
+        uint64_t counter {0};
+        TaSource source {TaSource::POP};
+    };
+
+    class Producer {
+    public:
+        // returns the data of the previous overflow; see the description of the class
+        std::optional<T> push(const T& data) { return roquet.push(data, *this); }
+
+        bool empty() { return roquet.queue.emptyForProducer(tailPosition); }
+
+        friend class WaitFreeRoQueT;
+
+    private:
+        Producer(WaitFreeRoQueT& r)
+            : roquet(r) {}
+
+    private:
+        WaitFreeRoQueT& roquet;
+        uint32_t        tailPosition {1};
+        uint64_t        pushCounter {0};
+        uint64_t        popCounter {0};
+        uint8_t         taPush {1};
+    };
+
+    class Consumer {
+    public:
+        std::optional<T> pop() { return roquet.pop(*this); }
+
+        // an overflowed element at the next position indicates that there is data unless it is older than the last popped one
+        bool empty() {
+            auto nextPosition = headPosition + 1;
+            if (nextPosition >= Queue::InternalCapacity) { nextPosition = 0; }
+            auto state = roquet.queue.stateAt(nextPosition).load(std::memory_order_acquire);
+            if (state & DATA) { return false; }
+            return !(state & OVERFLOW) || roquet.queue.dataAt(nextPosition).counter <= popCounter;
+        }
+
+        friend class WaitFreeRoQueT;
+
+    private:
+        Consumer(WaitFreeRoQueT& r)
+            : roquet(r) {}
+
+    private:
+        WaitFreeRoQueT& roquet;
+        uint32_t        headPosition {0};
+        uint64_t        popCounter {0};
+        uint8_t         taPop {0};
+    };
+
+public:
+    // TODO return optional<Producer> and ensure that a nullopt is returned after the second call
+    Producer producer() { return Producer(*this); }
+
+    // TODO return optional<Consumer> and ensure that a nullopt is returned after the second call
+    Consumer consumer() { return Consumer(*this); }
+
+private:
+    static constexpr uint8_t DATA {Queue::DATA};
+    static constexpr uint8_t EMPTY {Queue::EMPTY};
+    static constexpr uint8_t OVERFLOW {Queue::OVERFLOW};
+    static constexpr uint8_t INSPECTED {Queue::INSPECTED};
+    static constexpr uint8_t END {Queue::END};
+
+    // the first element has the counter 1 and is stored at position 1, which is the initial tail position
+    static uint32_t positionOf(uint64_t counter) { return static_cast<uint32_t>(counter % Queue::InternalCapacity); }
+
+    std::optional<T> push(const T& data, Producer& producer) {
+        // NOTE: don't return nullopt but always resource to make use of NRVO
+        std::optional<T> resource;
+        auto             currentPosition = producer.tailPosition;
+        auto             nextPosition    = currentPosition + 1;
+        if (nextPosition >= Queue::InternalCapacity) { nextPosition = 0; }
+
+        std::optional<Element> overflow;
+        if (!queue.advanceEnd(nextPosition, overflow)) {
+            // at this point the state at the next tail position should contain the END flag
+            // TODO use an expected to indicate a fishy state of the queue
+            return resource;
+        }
+
+        if (overflow.has_value()) {
+            auto& parked   = transactions[producer.taPush];
+            parked.value   = overflow->value;
+            parked.counter = overflow->counter;
+            parked.source  = TaSource::PUSH;
+
+            // the data at the next position must not be overwritten before this exchange since the consumer might use its copy
+            producer.taPush = taPending.exchange(producer.taPush, std::memory_order_acq_rel);
+
+            auto& previous = transactions[producer.taPush];
+            if (previous.source == TaSource::PUSH) {
+                // the consumer did not take the previously parked element
+                if (previous.counter > producer.popCounter) { resource.emplace(previous.value); }
+            } else if (previous.counter > producer.popCounter) {
+                producer.popCounter = previous.counter;
+            }
+        }
+
+        ++producer.pushCounter;
+        queue.dataAt(currentPosition) = Element {data, producer.pushCounter};
+        queue.stateAt(currentPosition).store(DATA, std::memory_order_release);
+
+        producer.tailPosition = nextPosition;
+        return resource;
+    }
+
+    std::optional<T> pop(Consumer& consumer) {
+        // NOTE: don't return nullopt but always resource to make use of NRVO
+        std::optional<T> resource;
+        auto             nextPosition = consumer.headPosition + 1;
+        if (nextPosition >= Queue::InternalCapacity) { nextPosition = 0; }
+
+        auto& state             = queue.stateAt(nextPosition);
+        auto  stateNextPosition = state.load(std::memory_order_acquire);
+
+        // set the inspected flag to prevent the ABA problem on a wrap-around; if this fails, the producer changed the state
+        if ((stateNextPosition & DATA) && !(stateNextPosition & INSPECTED)) {
+            if (state.compare_exchange_strong(stateNextPosition, stateNextPosition | INSPECTED, std::memory_order_release, std::memory_order_acquire)) {
+                stateNextPosition |= INSPECTED;
+            }
+        }
+
+        Element candidate {};
+        bool    isCandidateValid {false};
+        if ((stateNextPosition & DATA) && (stateNextPosition & INSPECTED)) {
+            candidate        = queue.dataAt(nextPosition);
+            isCandidateValid = candidate.counter == consumer.popCounter + 1;
+            if (isCandidateValid && state.compare_exchange_strong(stateNextPosition, EMPTY, std::memory_order_release, std::memory_order_acquire)) {
+                resource.emplace(candidate.value);
+                consumer.popCounter   = candidate.counter;
+                consumer.headPosition = nextPosition;
+                return resource;
+            }
+        } else if ((stateNextPosition & END) && (stateNextPosition & OVERFLOW)) {
+            // the overflowed data is not overwritten before the producer parked it and advanced the END flag to the following position
+            candidate = queue.dataAt(nextPosition);
+            if (candidate.counter <= consumer.popCounter) {
+                // queue is empty; the overflowed element was already skipped and the next one was not yet pushed
+                return resource;
+            }
+            auto followingPosition = nextPosition + 1;
+            if (followingPosition >= Queue::InternalCapacity) { followingPosition = 0; }
+            isCandidateValid = candidate.counter == consumer.popCounter + 1
+                               && !(queue.stateAt(followingPosition).load(std::memory_order_seq_cst) & END);
+        } else if (!(stateNextPosition & DATA)) {
+            // queue is empty; nothing newer than the last popped element could have been parked since the next one was not yet pushed
+            return resource;
+        }
+
+        // the exchange announces the counter of the element the consumer takes; if the producer parked a newer element, it is taken instead
+        auto& announcement   = transactions[consumer.taPop];
+        announcement.counter = isCandidateValid ? candidate.counter : consumer.popCounter;
+        announcement.source  = TaSource::POP;
+
+        consumer.taPop = taPending.exchange(consumer.taPop, std::memory_order_acq_rel);
+
+        auto& parked = transactions[consumer.taPop];
+        if (parked.source == TaSource::PUSH && parked.counter > consumer.popCounter) {
+            resource.emplace(parked.value);
+            consumer.popCounter   = parked.counter;
+            consumer.headPosition = positionOf(parked.counter);
+        } else if (isCandidateValid) {
+            // the producer did not yet park the candidate, therefore the copy is valid and the producer will see the announcement
+            resource.emplace(candidate.value);
+            consumer.popCounter   = candidate.counter;
+            consumer.headPosition = nextPosition;
+        }
+
+        return resource;
+    }
+
+private:
+    Queue                queue;
+    Transaction          transactions[3];
+    std::atomic<uint8_t> taPending {2};
+};
+
+#endif // _WAIT_FREE_ROQUET_HPP_
@@ -0,0 +1,47 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// SPDX-FileCopyrightText: © 2023 Mathias Kraus <elboberido@m-hias.de>
+
+#ifndef _TRANSFER_BENCHMARK_HPP_
+#define _TRANSFER_BENCHMARK_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+// measures the time per transfer in nanoseconds with a push and a pop thread; the push thread is throttled to stay at most 'distance'
+// elements ahead of the pop thread; 'push' pushes the counter of the element to the queue and 'pop' returns whether it got an element
+template <typename Push, typename Pop>
+double benchmarkThrottledTransfer(uint64_t numberOfTransfers, uint64_t distance, Push push, Pop pop) {
+    std::atomic<uint64_t> popCounter {0};
+
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    auto pushThread = std::thread([&] {
+        for (uint64_t pushCounter = 0; pushCounter < numberOfTransfers; ++pushCounter) {
+            while (pushCounter - popCounter.load(std::memory_order_relaxed) > distance) {
+                std::this_thread::yield();
+            }
+            push(pushCounter);
+        }
+    });
+
+    auto popThread = std::thread([&] {
+        uint64_t counter {0};
+        while (counter < numberOfTransfers) {
+            if (pop()) {
+                popCounter.store(++counter, std::memory_order_relaxed);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    pushThread.join();
+    popThread.join();
+
+    auto elapsedTime = std::chrono::high_resolution_clock::now() - startTime;
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsedTime).count()) / static_cast<double>(numberOfTransfers);
+}
+
+#endif // _TRANSFER_BENCHMARK_HPP_
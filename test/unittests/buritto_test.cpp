@@ -2,14 +2,17 @@
 // SPDX-FileCopyrightText: © 2018 - 2023 Mathias Kraus <elboberido@m-hias.de>
 
 #include "buritto.hpp"
+#include "transfer_benchmark.hpp"
 
 #define CATCH_CONFIG_ENABLE_BENCHMARKING
 #include "catch.hpp"
 
 #include <condition_variable>
 #include <iostream>
+#include <memory>
 #include <mutex>
 #include <thread>
+#include <vector>
 
 SCENARIO("BuRiTTO - Unittest") {
     constexpr std::uint32_t ContainerCapacity {10};
@@ -112,6 +115,263 @@ SCENARIO("BuRiTTO - Unittest") {
     }
 }
 
+SCENARIO("BuRiTTO - Move-only data") {
+    constexpr std::uint32_t ContainerCapacity {4};
+    using DataType = std::unique_ptr<size_t>;
+    using BuRiTTO  = BuRiTTO<DataType, ContainerCapacity>;
+
+    GIVEN("An BuRiTTO with a move-only data type") {
+        BuRiTTO  buritto;
+        DataType outValue;
+
+        WHEN("pushing more data than the capacity") {
+            constexpr size_t NumberOfPushes {3 * ContainerCapacity};
+            std::vector<size_t> overrunData;
+            for (size_t i = 0; i < NumberOfPushes; i++) {
+                if (!buritto.push(std::make_unique<size_t>(i), outValue)) {
+                    REQUIRE(outValue != nullptr);
+                    overrunData.push_back(*outValue);
+                    outValue.reset();
+                }
+            }
+
+            THEN("each data should be moved out exactly once either by push or by pop") {
+                std::vector<size_t> popData;
+                while (buritto.pop(outValue)) {
+                    REQUIRE(outValue != nullptr);
+                    popData.push_back(*outValue);
+                    outValue.reset();
+                }
+                REQUIRE(popData.size() == ContainerCapacity + 1);
+                REQUIRE(overrunData.size() + popData.size() == NumberOfPushes);
+                for (size_t i = 0; i < overrunData.size(); i++) {
+                    REQUIRE(overrunData[i] == i);
+                }
+                for (size_t i = 0; i < popData.size(); i++) {
+                    REQUIRE(popData[i] == overrunData.size() + i);
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("BuRiTTO - Batch") {
+    constexpr std::uint32_t ContainerCapacity {8};
+    constexpr std::uint32_t BatchSize {5};
+    using DataType = size_t;
+    using BuRiTTO  = BuRiTTO<DataType, ContainerCapacity>;
+
+    GIVEN("An BuRiTTO with a fixed capacity") {
+        BuRiTTO  buritto;
+        DataType pushCounter {0};
+        DataType inValues[BatchSize];
+        DataType outValues[BatchSize];
+
+        auto pushBatch = [&] {
+            for (auto& value : inValues) {
+                value = pushCounter++;
+            }
+            return buritto.pushBatch(inValues, BatchSize, outValues);
+        };
+
+        WHEN("pushing a batch into the empty buritto") {
+            auto numberOfOverruns = pushBatch();
+
+            THEN("nothing should overrun and the batch should be popped in order") {
+                REQUIRE(numberOfOverruns == 0);
+                REQUIRE(buritto.popBatch(outValues, BatchSize) == BatchSize);
+                for (DataType i = 0; i < BatchSize; i++) {
+                    REQUIRE(outValues[i] == i);
+                }
+                REQUIRE(buritto.empty() == true);
+                REQUIRE(buritto.popBatch(outValues, BatchSize) == 0);
+            }
+        }
+
+        WHEN("pushing batches until it overruns") {
+            std::vector<DataType> overrunData;
+            for (auto i = 0u; i < 4; i++) {
+                auto numberOfOverruns = pushBatch();
+                overrunData.insert(overrunData.end(), outValues, outValues + numberOfOverruns);
+            }
+
+            THEN("all but the newest overrun element should be returned in order and the rest should be popped in order") {
+                REQUIRE(overrunData.size() == 4 * BatchSize - ContainerCapacity - 1);
+                for (DataType i = 0; i < overrunData.size(); i++) {
+                    REQUIRE(overrunData[i] == i);
+                }
+
+                std::vector<DataType> popData;
+                while (auto numberOfValues = buritto.popBatch(outValues, BatchSize)) {
+                    popData.insert(popData.end(), outValues, outValues + numberOfValues);
+                }
+                REQUIRE(popData.size() == ContainerCapacity + 1);
+                for (DataType i = 0; i < popData.size(); i++) {
+                    REQUIRE(popData[i] == overrunData.size() + i);
+                }
+                REQUIRE(buritto.empty() == true);
+            }
+        }
+
+        WHEN("mixing batches with single pushes and pops") {
+            DataType outValue {0};
+            pushBatch();
+            REQUIRE(buritto.push(pushCounter++, outValue) == true);
+            REQUIRE(buritto.pop(outValue) == true);
+            REQUIRE(outValue == 0);
+
+            THEN("the order should be preserved") {
+                REQUIRE(buritto.popBatch(outValues, BatchSize) == BatchSize);
+                for (DataType i = 0; i < BatchSize; i++) {
+                    REQUIRE(outValues[i] == i + 1);
+                }
+                REQUIRE(buritto.empty() == true);
+            }
+        }
+    }
+}
+
+TEMPLATE_TEST_CASE("BuRiTTO - Layouts", "", BuRiTTOPackedLayout, BuRiTTOIsolatedLayout) {
+    constexpr std::uint32_t ContainerCapacity {10};
+    using DataType = size_t;
+    using BuRiTTO  = BuRiTTO<DataType, ContainerCapacity, TestType>;
+
+    BuRiTTO buritto;
+
+    // the BuRiTTO holds one more value in the pending transaction
+    constexpr DataType NumberOfPushes {ContainerCapacity + 4};
+    DataType           overrunCounter {0};
+    for (DataType i = 0; i < NumberOfPushes; ++i) {
+        DataType outValue {0};
+        if (!buritto.push(i, outValue)) {
+            REQUIRE(outValue == overrunCounter);
+            ++overrunCounter;
+        }
+    }
+    REQUIRE(overrunCounter == NumberOfPushes - ContainerCapacity - 1);
+
+    for (DataType i = overrunCounter; i < NumberOfPushes; ++i) {
+        DataType outValue {0};
+        REQUIRE(buritto.pop(outValue) == true);
+        REQUIRE(outValue == i);
+    }
+    REQUIRE(buritto.empty() == true);
+}
+
+SCENARIO("BuRiTTO - Statistics") {
+    constexpr std::uint32_t ContainerCapacity {10};
+    using DataType = size_t;
+    using BuRiTTO  = BuRiTTO<DataType, ContainerCapacity, BuRiTTOPackedLayout, BuRiTTOOperationStatistics>;
+
+    GIVEN("A BuRiTTO with statistics") {
+        BuRiTTO  buritto;
+        DataType outValue {0};
+
+        WHEN("pushing and popping data without overrun") {
+            for (DataType i = 0; i < ContainerCapacity; ++i) {
+                buritto.push(i, outValue);
+            }
+            while (buritto.pop(outValue)) {}
+
+            THEN("the pushes and pops should be counted without corrections") {
+                auto counters = buritto.counters();
+                REQUIRE(counters.pushes == ContainerCapacity);
+                REQUIRE(counters.overruns == 0);
+                REQUIRE(counters.pops == ContainerCapacity);
+                REQUIRE(counters.transactionCorrections == 0);
+            }
+        }
+
+        WHEN("overrunning the buritto with single and batch pushes") {
+            // the BuRiTTO holds one more value in the pending transaction
+            constexpr DataType NumberOfPushes {ContainerCapacity + 4};
+            DataType           inValues[] {NumberOfPushes, NumberOfPushes + 1};
+            DataType           outValues[2];
+            for (DataType i = 0; i < NumberOfPushes; ++i) {
+                buritto.push(i, outValue);
+            }
+            auto numberOfOverruns = buritto.pushBatch(inValues, 2, outValues);
+
+            THEN("the overruns and the correction of the read counter should be counted") {
+                REQUIRE(numberOfOverruns == 2);
+                REQUIRE(buritto.pop(outValue) == true);
+                REQUIRE(buritto.popBatch(outValues, 2) == 2);
+                while (buritto.pop(outValue)) {}
+
+                auto counters = buritto.counters();
+                REQUIRE(counters.pushes == NumberOfPushes + 2);
+                REQUIRE(counters.overruns == NumberOfPushes + 2 - ContainerCapacity - 1);
+                REQUIRE(counters.pops == ContainerCapacity + 1);
+                REQUIRE(counters.transactionCorrections == 1);
+            }
+        }
+    }
+}
+
+TEST_CASE("BuRiTTO - Dynamic capacity") {
+    using DataType = std::unique_ptr<size_t>;
+    using BuRiTTO  = BuRiTTO<DataType, BURITTO_DYNAMIC_CAPACITY>;
+
+    // a power of two and a non power of two capacity
+    const uint32_t ContainerCapacity = GENERATE(10, 16);
+
+    std::vector<uint64_t> memory((BuRiTTO::requiredMemorySize(ContainerCapacity) + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+    BuRiTTO               buritto(ContainerCapacity, memory.data());
+
+    // the BuRiTTO holds one more value in the pending transaction
+    const size_t NumberOfPushes {ContainerCapacity * 2 + 4};
+    size_t       overrunCounter {0};
+    for (size_t i = 0; i < NumberOfPushes; ++i) {
+        DataType outValue;
+        if (!buritto.push(std::make_unique<size_t>(i), outValue)) {
+            REQUIRE(*outValue == overrunCounter);
+            ++overrunCounter;
+        }
+    }
+    REQUIRE(overrunCounter == NumberOfPushes - ContainerCapacity - 1);
+
+    for (size_t i = overrunCounter; i < NumberOfPushes; ++i) {
+        DataType outValue;
+        REQUIRE(buritto.pop(outValue) == true);
+        REQUIRE(*outValue == i);
+    }
+    REQUIRE(buritto.empty() == true);
+}
+
+TEST_CASE("BuRiTTO - Blocking pop") {
+    constexpr std::uint32_t ContainerCapacity {10};
+    using DataType = size_t;
+    using BuRiTTO  = BuRiTTO<DataType, ContainerCapacity, BuRiTTOPackedLayout, BuRiTTONoStatistics, true>;
+
+    BuRiTTO  buritto;
+    DataType outValue {0};
+
+    SECTION("popWait on an empty buritto times out") {
+        auto startTime = std::chrono::steady_clock::now();
+        REQUIRE(buritto.popWait(outValue, std::chrono::milliseconds(10)) == false);
+        REQUIRE(std::chrono::steady_clock::now() - startTime >= std::chrono::milliseconds(10));
+    }
+
+    SECTION("popWait returns an available value immediately") {
+        buritto.push(42, outValue);
+        REQUIRE(buritto.popWait(outValue, std::chrono::seconds(10)) == true);
+        REQUIRE(outValue == 42);
+    }
+
+    SECTION("popWait is woken up by a push") {
+        auto pushThread = std::thread([&] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            DataType overrunValue {0};
+            buritto.push(13, overrunValue);
+        });
+
+        bool popped = buritto.popWait(outValue, std::chrono::seconds(10));
+        pushThread.join();
+        REQUIRE(popped == true);
+        REQUIRE(outValue == 13);
+    }
+}
+
 TEST_CASE("BuRiTTO - Stress", "[.stress]") {
     constexpr std::uint32_t ContainerCapacity {10};
     using DataType = uint64_t;
@@ -268,6 +528,51 @@ TEST_CASE("BuRiTTO - Stress", "[.stress]") {
     CHECK(pushCounter == (overrunCounter + popCounter));
 }
 
+TEST_CASE("BuRiTTO - Stress pop while overrunning", "[.stress]") {
+    // the small capacity lets the push thread overrun the element at the read counter most of the time
+    constexpr std::uint32_t ContainerCapacity {2};
+    using DataType = uint64_t;
+    using BuRiTTO  = BuRiTTO<DataType, ContainerCapacity>;
+
+    constexpr uint64_t NUMBER_OF_PUSHES {1000000};
+    constexpr uint32_t BatchSize {4};
+
+    BuRiTTO               buritto;
+    std::atomic<uint64_t> finishedPushes {0};
+
+    auto pushThread = std::thread([&] {
+        for (DataType i = 0; i < NUMBER_OF_PUSHES; i++) {
+            DataType out {0};
+            buritto.push(i, out);
+            finishedPushes.store(i + 1, std::memory_order_release);
+        }
+    });
+
+    // the newest element of a finished push is either in the BuRiTTO or was already popped, therefore a pop must not fail when this
+    // element is newer than the last popped one
+    uint64_t spuriousFailures {0};
+    uint64_t orderViolations {0};
+    DataType nextValue {0};
+    bool     useBatch {false};
+    while (nextValue < NUMBER_OF_PUSHES) {
+        auto     pushes = finishedPushes.load(std::memory_order_acquire);
+        DataType outValues[BatchSize];
+        uint32_t numberOfValues = useBatch ? buritto.popBatch(outValues, BatchSize) : (buritto.pop(outValues[0]) ? 1 : 0);
+        useBatch                = !useBatch;
+
+        if (numberOfValues == 0 && pushes > nextValue) { spuriousFailures++; }
+        for (uint32_t i = 0; i < numberOfValues; i++) {
+            if (outValues[i] < nextValue) { orderViolations++; }
+            nextValue = outValues[i] + 1;
+        }
+    }
+
+    pushThread.join();
+
+    REQUIRE(spuriousFailures == 0);
+    REQUIRE(orderViolations == 0);
+}
+
 TEST_CASE("BuRiTTO - Benchmark", "[!benchmark]") {
     constexpr std::uint32_t ContainerCapacity {100000};
     using DataType = size_t;
@@ -350,3 +655,64 @@ TEST_CASE("BuRiTTO - Benchmark", "[!benchmark]") {
     }
     REQUIRE(sum == expectedSum);
 }
+
+TEST_CASE("BuRiTTO - Batch benchmark", "[!benchmark]") {
+    constexpr std::uint32_t ContainerCapacity {100000};
+    constexpr uint32_t      BatchSize {32};
+    using DataType = size_t;
+    using BuRiTTO  = BuRiTTO<DataType, ContainerCapacity>;
+
+    BuRiTTO  buritto;
+    DataType outValue {0};
+    DataType inValues[BatchSize];
+    DataType outValues[BatchSize];
+    BENCHMARK("Push and pop BuRiTTO element by element") {
+        for (auto i = 0u; i < ContainerCapacity; i += BatchSize) {
+            for (auto j = 0u; j < BatchSize; j++) {
+                buritto.push(i + j, outValue);
+            }
+            for (auto j = 0u; j < BatchSize; j++) {
+                buritto.pop(outValue);
+            }
+        }
+    };
+
+    BENCHMARK("Push and pop BuRiTTO in batches") {
+        for (auto i = 0u; i < ContainerCapacity; i += BatchSize) {
+            for (auto j = 0u; j < BatchSize; j++) {
+                inValues[j] = i + j;
+            }
+            buritto.pushBatch(inValues, BatchSize, outValues);
+            buritto.popBatch(outValues, BatchSize);
+        }
+    };
+    REQUIRE(buritto.empty() == true);
+}
+
+// the push thread is throttled to stay at most 'distance' elements ahead of the pop thread
+template <typename Layout>
+double benchmarkBuRiTTOLayout(uint64_t distance) {
+    constexpr std::uint32_t ContainerCapacity {64};
+    constexpr uint64_t      NUMBER_OF_TRANSFERS {1000000};
+    using DataType = uint64_t;
+    using BuRiTTO  = BuRiTTO<DataType, ContainerCapacity, Layout>;
+
+    auto     buritto = std::make_unique<BuRiTTO>();
+    DataType overrunValue {0};
+    DataType outValue {0};
+
+    return benchmarkThrottledTransfer(
+        NUMBER_OF_TRANSFERS, distance, [&](DataType data) { buritto->push(data, overrunValue); }, [&] { return buritto->pop(outValue); });
+}
+
+TEST_CASE("BuRiTTO - Layout benchmark", "[!benchmark]") {
+    constexpr uint64_t ContainerCapacity {64};
+
+    std::cout << "distance \tpacked [ns] \tisolated [ns]" << std::endl;
+    for (uint64_t distance = 0; distance <= ContainerCapacity; distance = distance == 0 ? 1 : distance * 2) {
+        std::cout << distance;
+        std::cout << " \t" << benchmarkBuRiTTOLayout<BuRiTTOPackedLayout>(distance);
+        std::cout << " \t" << benchmarkBuRiTTOLayout<BuRiTTOIsolatedLayout>(distance);
+        std::cout << std::endl;
+    }
+}
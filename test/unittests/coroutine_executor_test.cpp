@@ -0,0 +1,116 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// SPDX-FileCopyrightText: © 2023 Mathias Kraus <elboberido@m-hias.de>
+
+#include "buritto.hpp"
+#include "coroutine_executor.hpp"
+#include "roquet.hpp"
+
+#include "catch.hpp"
+
+#include <memory>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+SCENARIO("CoroutineExecutor - Unittest") {
+    constexpr std::uint32_t ContainerCapacity {10};
+    using DataType = size_t;
+
+    GIVEN("A RoQueT consumed by a coroutine") {
+        RoQueT<DataType, ContainerCapacity> roquet;
+        auto                                producer       = roquet.producer();
+        auto                                roquetConsumer = roquet.consumer();
+
+        Executor      executor;
+        AsyncConsumer consumer(executor, [&roquetConsumer] { return roquetConsumer.pop(); });
+
+        constexpr DataType    NumberOfPushes {1000};
+        std::vector<DataType> popData;
+        executor.spawn([](auto& consumer, auto& popData) -> Task {
+            for (DataType i = 0; i < NumberOfPushes; ++i) {
+                popData.push_back(co_await consumer.next());
+            }
+        }(consumer, popData));
+
+        WHEN("the data is pushed before the executor runs") {
+            for (DataType i = 0; i < ContainerCapacity; ++i) {
+                producer.push(i);
+                consumer.notify();
+            }
+            auto pushThread = std::thread([&] {
+                for (DataType i = ContainerCapacity; i < NumberOfPushes; ++i) {
+                    while (!producer.empty()) {
+                        std::this_thread::yield();
+                    }
+                    producer.push(i);
+                    consumer.notify();
+                }
+            });
+
+            executor.run();
+            pushThread.join();
+
+            THEN("the coroutine should receive all data in order") {
+                REQUIRE(popData.size() == NumberOfPushes);
+                for (DataType i = 0; i < NumberOfPushes; ++i) {
+                    REQUIRE(popData[i] == i);
+                }
+            }
+        }
+    }
+
+    GIVEN("Several BuRiTTOs consumed by coroutines on one executor") {
+        constexpr uint32_t NumberOfQueues {8};
+        constexpr DataType NumberOfPushes {100};
+        using BuRiTTO = BuRiTTO<DataType, ContainerCapacity>;
+
+        auto pop = [](BuRiTTO& buritto) {
+            return [&buritto] {
+                std::optional<DataType> data;
+                DataType                value {0};
+                if (buritto.pop(value)) { data.emplace(value); }
+                return data;
+            };
+        };
+        using Consumer = AsyncConsumer<decltype(pop(std::declval<BuRiTTO&>()))>;
+
+        Executor                               executor;
+        std::vector<std::unique_ptr<BuRiTTO>>  burittos;
+        std::vector<std::unique_ptr<Consumer>> consumers;
+        std::vector<DataType>                  sums(NumberOfQueues, 0);
+        for (uint32_t i = 0; i < NumberOfQueues; ++i) {
+            burittos.push_back(std::make_unique<BuRiTTO>());
+            consumers.push_back(std::make_unique<Consumer>(executor, pop(*burittos.back())));
+            executor.spawn([](auto& consumer, auto& sum) -> Task {
+                for (DataType i = 0; i < NumberOfPushes; ++i) {
+                    sum += co_await consumer.next();
+                }
+            }(*consumers.back(), sums[i]));
+        }
+
+        WHEN("the producers push from another thread") {
+            auto pushThread = std::thread([&] {
+                DataType outValue {0};
+                for (DataType i = 0; i < NumberOfPushes; ++i) {
+                    for (uint32_t q = 0; q < NumberOfQueues; ++q) {
+                        while (!burittos[q]->empty()) {
+                            std::this_thread::yield();
+                        }
+                        burittos[q]->push(i, outValue);
+                        consumers[q]->notify();
+                    }
+                }
+            });
+
+            executor.run();
+            pushThread.join();
+
+            THEN("each coroutine should receive all data") {
+                for (auto sum : sums) {
+                    REQUIRE(sum == NumberOfPushes * (NumberOfPushes - 1) / 2);
+                }
+            }
+        }
+    }
+}
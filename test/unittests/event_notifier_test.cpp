@@ -0,0 +1,200 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// SPDX-FileCopyrightText: © 2023 Mathias Kraus <elboberido@m-hias.de>
+
+#include "buritto.hpp"
+#include "event_notifier.hpp"
+#include "shared_roquet.hpp"
+
+#include "catch.hpp"
+
+#include <string>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+bool isReadable(int fd, int timeoutInMs) {
+    pollfd pollFd {fd, POLLIN, 0};
+    return poll(&pollFd, 1, timeoutInMs) == 1 && (pollFd.revents & POLLIN);
+}
+
+uint64_t readEventCounter(int fd) {
+    uint64_t value {0};
+    if (read(fd, &value, sizeof(value)) != sizeof(value)) { return 0; }
+    return value;
+}
+} // namespace
+
+SCENARIO("EventNotifier - Unittest") {
+    constexpr std::uint32_t ContainerCapacity {10};
+    using DataType = size_t;
+
+    GIVEN("A RoQueT with an EventNotifier") {
+        RoQueT<DataType, ContainerCapacity> roquet;
+        auto                                producer = roquet.producer();
+        auto                                consumer = roquet.consumer();
+
+        EventNotifier::State state;
+        REQUIRE(EventNotifier::open(state).has_value() == false);
+
+        auto consumerNotifier = EventNotifier::create(state);
+        REQUIRE(consumerNotifier.has_value() == true);
+        auto producerNotifier = EventNotifier::open(state);
+        REQUIRE(producerNotifier.has_value() == true);
+
+        WHEN("pushing data without arming the notifier") {
+            producer.push(42);
+            producerNotifier->notify();
+
+            THEN("the file descriptor should not become readable") {
+                REQUIRE(isReadable(consumerNotifier->fd(), 0) == false);
+            }
+        }
+
+        WHEN("pushing data several times after arming the notifier") {
+            consumerNotifier->arm();
+            REQUIRE(consumer.empty() == true);
+            for (DataType i = 0; i < 3; ++i) {
+                producer.push(i);
+                producerNotifier->notify();
+            }
+
+            THEN("the file descriptor should become readable with a single signal") {
+                REQUIRE(isReadable(consumerNotifier->fd(), 0) == true);
+                REQUIRE(readEventCounter(consumerNotifier->fd()) == 1);
+            }
+
+            AND_WHEN("the consumer acknowledges and drains the queue") {
+                consumerNotifier->acknowledge();
+                REQUIRE(consumer.drain([](const DataType&) {}) == 3);
+
+                THEN("the file descriptor should not be readable") {
+                    REQUIRE(isReadable(consumerNotifier->fd(), 0) == false);
+                }
+            }
+        }
+
+        WHEN("pushing data with a NotifyingProducer after arming the notifier") {
+            NotifyingProducer notifyingProducer {producer, *producerNotifier};
+            consumerNotifier->arm();
+            REQUIRE(consumer.empty() == true);
+            REQUIRE(notifyingProducer.push(42).has_value() == false);
+
+            THEN("the file descriptor should become readable without an explicit notify") {
+                REQUIRE(isReadable(consumerNotifier->fd(), 0) == true);
+                consumerNotifier->acknowledge();
+
+                AND_THEN("a commit of a loan should notify the rearmed notifier as well") {
+                    REQUIRE(consumer.drain([](const DataType&) {}) == 1);
+                    consumerNotifier->arm();
+                    auto loan = notifyingProducer->loan().loan;
+                    REQUIRE(loan.has_value() == true);
+                    **loan = 13;
+                    notifyingProducer.commit(*loan);
+                    REQUIRE(isReadable(consumerNotifier->fd(), 0) == true);
+                }
+
+                AND_THEN("a cancellable push should notify the rearmed notifier as well") {
+                    REQUIRE(consumer.drain([](const DataType&) {}) == 1);
+                    consumerNotifier->arm();
+                    decltype(roquet)::CancelHandle handle;
+                    REQUIRE(notifyingProducer.push_cancellable(13, handle).status == PushStatus::PUSHED);
+                    REQUIRE(isReadable(consumerNotifier->fd(), 0) == true);
+                }
+            }
+        }
+    }
+
+    GIVEN("A BuRiTTO with an EventNotifier") {
+        BuRiTTO<DataType, ContainerCapacity> buritto;
+        EventNotifier::State                 state;
+        auto                                 consumerNotifier = EventNotifier::create(state);
+        auto                                 producerNotifier = EventNotifier::open(state);
+        REQUIRE(consumerNotifier.has_value() == true);
+        REQUIRE(producerNotifier.has_value() == true);
+        NotifyingProducer notifyingProducer {buritto, *producerNotifier};
+
+        WHEN("pushing data after arming the notifier") {
+            DataType outValue {0};
+            consumerNotifier->arm();
+            REQUIRE(buritto.empty() == true);
+            notifyingProducer.push(13, outValue);
+
+            THEN("the file descriptor should become readable and the data can be popped") {
+                REQUIRE(isReadable(consumerNotifier->fd(), 0) == true);
+                consumerNotifier->acknowledge();
+                REQUIRE(buritto.pop(outValue) == true);
+                REQUIRE(outValue == 13);
+            }
+        }
+
+        WHEN("pushing a batch after arming the notifier") {
+            DataType inValues[] {1, 2, 3};
+            DataType outValues[3] {};
+            consumerNotifier->arm();
+            REQUIRE(buritto.empty() == true);
+            REQUIRE(notifyingProducer.pushBatch(inValues, 3, outValues) == 0);
+
+            THEN("the file descriptor should become readable and the batch can be popped") {
+                REQUIRE(isReadable(consumerNotifier->fd(), 0) == true);
+                consumerNotifier->acknowledge();
+                REQUIRE(buritto.popBatch(outValues, 3) == 3);
+                REQUIRE(outValues[0] == 1);
+                REQUIRE(outValues[2] == 3);
+            }
+        }
+    }
+
+    GIVEN("A SharedRoQueT with an EventNotifier") {
+        using SharedRoQueT = SharedRoQueT<DataType, ContainerCapacity>;
+
+        const std::string name {"/roquet_notifier_unittest_" + std::to_string(getpid())};
+        auto              created = SharedRoQueT::create(name);
+        REQUIRE(created.has_value() == true);
+
+        auto consumerNotifier = EventNotifier::create(created->notifier_state());
+        REQUIRE(consumerNotifier.has_value() == true);
+        consumerNotifier->arm();
+
+        WHEN("a second process receives the notifier via a Unix domain socket and pushes data") {
+            int sockets[2];
+            REQUIRE(socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sockets) == 0);
+
+            auto pid = fork();
+            REQUIRE(pid != -1);
+            if (pid == 0) {
+                close(sockets[0]);
+                auto opened = SharedRoQueT::open(name);
+                if (!opened.has_value()) { _exit(1); }
+                // the eventfd of another process cannot be opened but has to be received
+                if (EventNotifier::open(opened->notifier_state()).has_value()) { _exit(2); }
+                auto producerNotifier = EventNotifier::receive(opened->notifier_state(), sockets[1]);
+                if (!producerNotifier.has_value()) { _exit(3); }
+                auto              producer = opened->roquet().producer();
+                NotifyingProducer notifyingProducer {producer, *producerNotifier};
+                notifyingProducer.push(73);
+                _exit(0);
+            }
+
+            close(sockets[1]);
+            REQUIRE(consumerNotifier->share(sockets[0]) == true);
+            close(sockets[0]);
+
+            int status {0};
+            waitpid(pid, &status, 0);
+
+            THEN("the first process should be notified and pop the data") {
+                REQUIRE(WIFEXITED(status));
+                REQUIRE(WEXITSTATUS(status) == 0);
+
+                REQUIRE(isReadable(consumerNotifier->fd(), 1000) == true);
+                consumerNotifier->acknowledge();
+                auto popReturnValue = created->roquet().consumer().pop();
+                REQUIRE(popReturnValue.has_value() == true);
+                REQUIRE(popReturnValue.value() == 73);
+            }
+        }
+    }
+}
@@ -0,0 +1,54 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// SPDX-FileCopyrightText: © 2023 Mathias Kraus <elboberido@m-hias.de>
+
+#include "index_queue.hpp"
+
+#include "catch.hpp"
+
+SCENARIO("IndexQueue - Unittest") {
+    constexpr std::uint32_t ContainerCapacity {10};
+    using IndexQueue = IndexQueue<ContainerCapacity>;
+
+    GIVEN("An empty IndexQueue") {
+        IndexQueue indexQueue;
+
+        WHEN("the index queue was just created") {
+            THEN("it should be empty") {
+                uint32_t index {0};
+                REQUIRE(indexQueue.empty() == true);
+                REQUIRE(indexQueue.pop(index) == false);
+            }
+        }
+
+        WHEN("pushing and popping more indices than the capacity") {
+            bool     indicesInOrder {true};
+            uint32_t index {0};
+            for (uint32_t i = 0; i < ContainerCapacity * 3; ++i) {
+                indexQueue.push(i % ContainerCapacity);
+                indicesInOrder &= indexQueue.pop(index);
+                indicesInOrder &= index == i % ContainerCapacity;
+            }
+
+            THEN("it should return the indices in order and be empty") {
+                REQUIRE(indicesInOrder == true);
+                REQUIRE(indexQueue.empty() == true);
+            }
+        }
+    }
+
+    GIVEN("A full IndexQueue") {
+        IndexQueue indexQueue {IndexQueue::Fill::FULL};
+
+        WHEN("popping all indices") {
+            THEN("it should return all indices in order and be empty") {
+                uint32_t index {0};
+                for (uint32_t i = 0; i < ContainerCapacity; ++i) {
+                    REQUIRE(indexQueue.pop(index) == true);
+                    REQUIRE(index == i);
+                }
+                REQUIRE(indexQueue.empty() == true);
+                REQUIRE(indexQueue.pop(index) == false);
+            }
+        }
+    }
+}
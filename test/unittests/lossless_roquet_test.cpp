@@ -0,0 +1,157 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// SPDX-FileCopyrightText: © 2023 Mathias Kraus <elboberido@m-hias.de>
+
+#include "lossless_roquet.hpp"
+#include "roquet.hpp"
+#include "transfer_benchmark.hpp"
+
+#include "catch.hpp"
+
+#include <iostream>
+#include <memory>
+#include <thread>
+
+SCENARIO("LosslessRoQueT - Unittest") {
+    constexpr std::uint32_t ContainerCapacity {10};
+    constexpr std::uint32_t QueueSize {ContainerCapacity + 1};
+    using DataType       = size_t;
+    using LosslessRoQueT = LosslessRoQueT<DataType, ContainerCapacity>;
+
+    GIVEN("A LosslessRoQueT with a fixed capacity") {
+        auto roquet   = std::make_unique<LosslessRoQueT>();
+        auto producer = roquet->producer();
+        auto consumer = roquet->consumer();
+
+        WHEN("the roquet was just created") {
+            THEN("it should be empty") {
+                REQUIRE(producer.empty() == true);
+                REQUIRE(consumer.empty() == true);
+                REQUIRE(consumer.pop().has_value() == false);
+            }
+        }
+
+        WHEN("pushing data up to the queue size") {
+            for (DataType i = 0; i < QueueSize; ++i) {
+                REQUIRE(producer.try_push(i) == true);
+            }
+
+            THEN("further pushes should be refused") {
+                REQUIRE(producer.try_push(QueueSize) == false);
+                REQUIRE(producer.try_push(QueueSize) == false);
+                REQUIRE(producer.empty() == false);
+                REQUIRE(consumer.empty() == false);
+            }
+
+            THEN("the data should be popped in order") {
+                for (DataType i = 0; i < QueueSize; ++i) {
+                    auto popReturnValue = consumer.pop();
+                    REQUIRE(popReturnValue.has_value() == true);
+                    REQUIRE(popReturnValue.value() == i);
+                }
+                REQUIRE(consumer.empty() == true);
+                REQUIRE(consumer.pop().has_value() == false);
+            }
+
+            AND_WHEN("popping one element") {
+                REQUIRE(producer.try_push(QueueSize) == false);
+                auto popReturnValue = consumer.pop();
+                REQUIRE(popReturnValue.has_value() == true);
+                REQUIRE(popReturnValue.value() == 0);
+
+                THEN("exactly one more element should be accepted") {
+                    REQUIRE(producer.try_push(QueueSize) == true);
+                    REQUIRE(producer.try_push(QueueSize + 1) == false);
+                    for (DataType i = 1; i <= QueueSize; ++i) {
+                        popReturnValue = consumer.pop();
+                        REQUIRE(popReturnValue.has_value() == true);
+                        REQUIRE(popReturnValue.value() == i);
+                    }
+                    REQUIRE(consumer.pop().has_value() == false);
+                }
+            }
+        }
+
+        WHEN("pushing and popping multiple wrap-arounds") {
+            constexpr DataType NumberOfPushes {7 * QueueSize + 3};
+            DataType           popCounter {0};
+            for (DataType i = 0; i < NumberOfPushes; ++i) {
+                if (!producer.try_push(i)) {
+                    auto popReturnValue = consumer.pop();
+                    REQUIRE(popReturnValue.has_value() == true);
+                    REQUIRE(popReturnValue.value() == popCounter++);
+                    REQUIRE(producer.try_push(i) == true);
+                }
+            }
+
+            THEN("no data should be lost") {
+                while (auto popReturnValue = consumer.pop()) {
+                    REQUIRE(popReturnValue.value() == popCounter++);
+                }
+                REQUIRE(popCounter == NumberOfPushes);
+            }
+        }
+    }
+}
+
+TEST_CASE("LosslessRoQueT - Transfer between threads") {
+    constexpr std::uint32_t ContainerCapacity {10};
+    constexpr uint64_t      NUMBER_OF_TRANSFERS {200000};
+    using DataType       = uint64_t;
+    using LosslessRoQueT = LosslessRoQueT<DataType, ContainerCapacity>;
+
+    auto roquet   = std::make_unique<LosslessRoQueT>();
+    auto producer = roquet->producer();
+    auto consumer = roquet->consumer();
+
+    auto pushThread = std::thread([&] {
+        for (DataType i = 0; i < NUMBER_OF_TRANSFERS; ++i) {
+            while (!producer.try_push(i)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    uint64_t popCounter {0};
+    bool     inOrder {true};
+    while (popCounter < NUMBER_OF_TRANSFERS) {
+        if (auto popReturnValue = consumer.pop()) {
+            inOrder &= popReturnValue.value() == popCounter;
+            ++popCounter;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+
+    pushThread.join();
+
+    REQUIRE(inOrder == true);
+    REQUIRE(consumer.pop().has_value() == false);
+}
+
+namespace {
+// the producer stays at most half of the capacity ahead of the consumer, therefore the RoQueT does not overflow and both queues are lossless
+template <typename Queue, typename Push>
+double benchmarkLosslessTransfer(Push push) {
+    constexpr uint64_t NUMBER_OF_TRANSFERS {10000000};
+    constexpr uint64_t DISTANCE {32};
+
+    auto roquet   = std::make_unique<Queue>();
+    auto producer = roquet->producer();
+    auto consumer = roquet->consumer();
+
+    return benchmarkThrottledTransfer(
+        NUMBER_OF_TRANSFERS, DISTANCE, [&](uint64_t data) { push(producer, data); }, [&] { return consumer.pop().has_value(); });
+}
+} // namespace
+
+TEST_CASE("LosslessRoQueT - Transfer benchmark", "[!benchmark]") {
+    constexpr std::uint32_t ContainerCapacity {64};
+    using DataType = uint64_t;
+
+    auto roquetPush   = [](auto& producer, DataType data) { producer.push(data); };
+    auto losslessPush = [](auto& producer, DataType data) { producer.try_push(data); };
+
+    std::cout << "lossless roquet [ns] \troquet [ns]" << std::endl;
+    std::cout << benchmarkLosslessTransfer<LosslessRoQueT<DataType, ContainerCapacity>>(losslessPush);
+    std::cout << " \t" << benchmarkLosslessTransfer<RoQueT<DataType, ContainerCapacity>>(roquetPush) << std::endl;
+}
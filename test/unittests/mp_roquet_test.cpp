@@ -0,0 +1,229 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// SPDX-FileCopyrightText: © 2023 Mathias Kraus <elboberido@m-hias.de>
+
+#include "mp_roquet.hpp"
+
+#include "catch.hpp"
+
+#include <iostream>
+#include <thread>
+#include <vector>
+
+SCENARIO("MpRoQueT - Unittest") {
+    constexpr std::uint32_t ContainerCapacity {10};
+    using DataType = size_t;
+    using MpRoQueT = MpRoQueT<DataType, ContainerCapacity>;
+
+    GIVEN("An MpRoQueT with a fixed capacity") {
+        MpRoQueT roquet;
+        auto     producer = roquet.producer().value();
+        auto     consumer = roquet.consumer();
+
+        WHEN("the roquet was just created") {
+            THEN("it should be empty and not return data") {
+                REQUIRE(consumer.empty() == true);
+                REQUIRE(consumer.pop().has_value() == false);
+            }
+        }
+
+        WHEN("filling the roquet to the point before overrun") {
+            std::optional<DataType> pushReturnValue;
+            for (DataType i = 0; i < ContainerCapacity; ++i) {
+                pushReturnValue = producer.push(i);
+                if (pushReturnValue.has_value()) { break; }
+            }
+
+            THEN("it should not overrun and not be empty") {
+                REQUIRE(pushReturnValue.has_value() == false);
+                REQUIRE(consumer.empty() == false);
+            }
+
+            AND_WHEN("pushing more data with a second producer") {
+                auto secondProducer = roquet.producer().value();
+                pushReturnValue     = secondProducer.push(ContainerCapacity);
+
+                THEN("it should overrun and return the oldest data") {
+                    REQUIRE(pushReturnValue.has_value() == true);
+                    REQUIRE(pushReturnValue.value() == 0);
+                }
+
+                AND_WHEN("pop all data out") {
+                    THEN("it should return the data in order and be empty") {
+                        for (DataType i = 1; i <= ContainerCapacity; ++i) {
+                            auto popReturnValue = consumer.pop();
+                            REQUIRE(popReturnValue.has_value() == true);
+                            REQUIRE(popReturnValue.value() == i);
+                        }
+                        REQUIRE(consumer.empty() == true);
+                        REQUIRE(consumer.pop().has_value() == false);
+                    }
+                }
+            }
+        }
+
+        WHEN("the producer overruns the consumer by more than one wrap-around") {
+            constexpr DataType NumberOfPushes {ContainerCapacity * 2 + 3};
+            DataType           overrunCounter {0};
+            for (DataType i = 0; i < NumberOfPushes; ++i) {
+                if (producer.push(i).has_value()) { ++overrunCounter; }
+            }
+
+            THEN("it should return the newest data in order") {
+                REQUIRE(overrunCounter == NumberOfPushes - ContainerCapacity);
+                for (DataType i = NumberOfPushes - ContainerCapacity; i < NumberOfPushes; ++i) {
+                    auto popReturnValue = consumer.pop();
+                    REQUIRE(popReturnValue.has_value() == true);
+                    REQUIRE(popReturnValue.value() == i);
+                }
+                REQUIRE(consumer.empty() == true);
+            }
+        }
+    }
+}
+
+TEST_CASE("MpRoQueT - Producer limit") {
+    constexpr std::uint32_t ContainerCapacity {4};
+    using DataType = uint64_t;
+    using MpRoQueT = MpRoQueT<DataType, ContainerCapacity>;
+    constexpr uint32_t MaxProducers {8};
+
+    MpRoQueT roquet;
+    auto     consumer = roquet.consumer();
+
+    std::vector<decltype(roquet.producer())> producers;
+    for (uint32_t i = 0; i < MaxProducers; ++i) {
+        producers.push_back(roquet.producer());
+        REQUIRE(producers.back().has_value());
+    }
+
+    SECTION("no more producers than the default MaxConcurrentPushes") {
+        REQUIRE(roquet.producer().has_value() == false);
+
+        producers.pop_back();
+        auto producer = roquet.producer();
+        REQUIRE(producer.has_value());
+        REQUIRE(roquet.producer().has_value() == false);
+    }
+
+    SECTION("all producers push concurrently to a full queue") {
+        constexpr uint64_t NUMBER_OF_PUSHES_PER_PRODUCER {10000};
+        constexpr uint32_t ID_SHIFT {32};
+
+        std::vector<std::vector<DataType>> overrunData(MaxProducers);
+        std::vector<uint8_t>               ownDataReturned(MaxProducers, 0);
+
+        std::vector<std::thread> pushThreads;
+        for (uint32_t id = 0; id < MaxProducers; ++id) {
+            pushThreads.emplace_back([&, id] {
+                for (uint64_t i = 0; i < NUMBER_OF_PUSHES_PER_PRODUCER; ++i) {
+                    auto data   = (static_cast<DataType>(id) << ID_SHIFT) | i;
+                    auto retVal = producers[id]->push(data);
+                    if (retVal.has_value()) {
+                        // the chunk pool must never run dry and return the data which was just pushed
+                        if (retVal.value() == data) { ownDataReturned[id] = true; }
+                        overrunData[id].push_back(retVal.value());
+                    }
+                }
+            });
+        }
+        for (auto& pushThread : pushThreads) {
+            pushThread.join();
+        }
+
+        std::vector<uint64_t> seen(MaxProducers * NUMBER_OF_PUSHES_PER_PRODUCER, 0);
+        uint64_t              popCounter {0};
+        while (auto retVal = consumer.pop()) {
+            ++seen[(retVal.value() >> ID_SHIFT) * NUMBER_OF_PUSHES_PER_PRODUCER + (retVal.value() & ((1ULL << ID_SHIFT) - 1))];
+            ++popCounter;
+        }
+        for (uint32_t id = 0; id < MaxProducers; ++id) {
+            REQUIRE(ownDataReturned[id] == 0);
+            for (auto data : overrunData[id]) {
+                ++seen[(data >> ID_SHIFT) * NUMBER_OF_PUSHES_PER_PRODUCER + (data & ((1ULL << ID_SHIFT) - 1))];
+            }
+        }
+        bool dataIntact {true};
+        for (auto count : seen) {
+            dataIntact &= count == 1;
+        }
+
+        REQUIRE(popCounter == ContainerCapacity);
+        REQUIRE(dataIntact);
+    }
+}
+
+TEST_CASE("MpRoQueT - Stress", "[.stress]") {
+    constexpr std::uint32_t ContainerCapacity {10};
+    constexpr uint32_t      NUMBER_OF_PRODUCERS {4};
+    using DataType = uint64_t;
+    using MpRoQueT = MpRoQueT<DataType, ContainerCapacity, NUMBER_OF_PRODUCERS>;
+
+    constexpr uint64_t NUMBER_OF_PUSHES_PER_PRODUCER {250000};
+
+    // the upper bits of the data contain the producer id and the lower bits a counter
+    constexpr uint32_t ID_SHIFT {32};
+
+    std::atomic<uint32_t> finishedProducers {0};
+
+    MpRoQueT roquet;
+    auto     consumer = roquet.consumer();
+
+    std::vector<std::vector<DataType>> overrunData(NUMBER_OF_PRODUCERS);
+    std::vector<DataType>              popData;
+
+    std::vector<std::thread> pushThreads;
+    for (uint32_t id = 0; id < NUMBER_OF_PRODUCERS; ++id) {
+        pushThreads.emplace_back([&, id] {
+            auto producer = roquet.producer().value();
+            for (uint64_t i = 0; i < NUMBER_OF_PUSHES_PER_PRODUCER; ++i) {
+                auto retVal = producer.push((static_cast<DataType>(id) << ID_SHIFT) | i);
+                if (retVal.has_value()) { overrunData[id].push_back(retVal.value()); }
+            }
+            finishedProducers.fetch_add(1);
+        });
+    }
+
+    auto popThread = std::thread([&] {
+        while (finishedProducers.load() < NUMBER_OF_PRODUCERS || !consumer.empty()) {
+            auto retVal = consumer.pop();
+            if (retVal.has_value()) { popData.push_back(retVal.value()); }
+        }
+    });
+
+    for (auto& pushThread : pushThreads) {
+        pushThread.join();
+    }
+    popThread.join();
+
+    // the data of each producer must be popped in order and each value must be either popped or returned by a push exactly once
+    std::vector<DataType>  lastPopped(NUMBER_OF_PRODUCERS, 0);
+    std::vector<bool>      anyPopped(NUMBER_OF_PRODUCERS, false);
+    std::vector<uint64_t>  seen(NUMBER_OF_PRODUCERS * NUMBER_OF_PUSHES_PER_PRODUCER, 0);
+    bool                   popOrderIntact {true};
+    for (auto data : popData) {
+        auto id      = static_cast<uint32_t>(data >> ID_SHIFT);
+        auto counter = data & ((1ULL << ID_SHIFT) - 1);
+        if (anyPopped[id] && counter <= lastPopped[id]) { popOrderIntact = false; }
+        anyPopped[id]  = true;
+        lastPopped[id] = counter;
+        ++seen[id * NUMBER_OF_PUSHES_PER_PRODUCER + counter];
+    }
+    uint64_t overrunCounter {0};
+    for (uint32_t id = 0; id < NUMBER_OF_PRODUCERS; ++id) {
+        for (auto data : overrunData[id]) {
+            ++seen[(data >> ID_SHIFT) * NUMBER_OF_PUSHES_PER_PRODUCER + (data & ((1ULL << ID_SHIFT) - 1))];
+        }
+        overrunCounter += overrunData[id].size();
+    }
+    bool dataIntact {true};
+    for (auto count : seen) {
+        dataIntact &= count == 1;
+    }
+
+    std::cout << "overrun counter \t" << overrunCounter << std::endl;
+    std::cout << "pop counter \t" << popData.size() << std::endl;
+
+    CHECK(popOrderIntact);
+    CHECK(dataIntact);
+    CHECK(overrunCounter + popData.size() == NUMBER_OF_PRODUCERS * NUMBER_OF_PUSHES_PER_PRODUCER);
+}
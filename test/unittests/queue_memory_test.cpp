@@ -0,0 +1,103 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// SPDX-FileCopyrightText: © 2023 Mathias Kraus <elboberido@m-hias.de>
+
+#include "buritto.hpp"
+#include "queue_memory.hpp"
+#include "roquet.hpp"
+#include "transfer_benchmark.hpp"
+
+#include "catch.hpp"
+
+#include <iostream>
+
+using PageSize = QueueMemory::PageSize;
+
+SCENARIO("QueueMemory - Unittest") {
+    using DataType = size_t;
+
+    GIVEN("A RoQueT with a dynamic capacity") {
+        using RoQueT = RoQueT<DataType, DYNAMIC_CAPACITY>;
+        constexpr uint64_t ContainerCapacity {1000};
+
+        WHEN("the memory is allocated with any page size on the NUMA node of the consumer") {
+            const auto requestedPageSize = GENERATE(PageSize::REGULAR, PageSize::HUGE_2MIB, PageSize::HUGE_1GIB);
+            const auto numaNode          = QueueMemory::current_numa_node();
+            auto       memory = QueueMemory::allocate(RoQueT::required_memory_size(ContainerCapacity), requestedPageSize, numaNode);
+
+            THEN("the memory should be allocated, possibly with a smaller page size, and be usable for the RoQueT") {
+                REQUIRE(memory.has_value() == true);
+                REQUIRE(memory->page_size() <= requestedPageSize);
+                REQUIRE(memory->size() >= RoQueT::required_memory_size(ContainerCapacity));
+                REQUIRE(memory->size() % QueueMemory::page_size_in_bytes(memory->page_size()) == 0);
+                // only the fallback to regular pages is advised to be backed by transparent hugepages
+                if (memory->page_size() != PageSize::REGULAR || requestedPageSize == PageSize::REGULAR) {
+                    REQUIRE(memory->hugepage_advised() == false);
+                }
+
+                RoQueT roquet(ContainerCapacity, memory->get());
+                auto   producer = roquet.producer();
+                auto   consumer = roquet.consumer();
+                for (DataType i = 0; i < ContainerCapacity; ++i) {
+                    REQUIRE(producer.push(i).has_value() == false);
+                }
+                for (DataType i = 0; i < ContainerCapacity; ++i) {
+                    auto popReturnValue = consumer.pop();
+                    REQUIRE(popReturnValue.has_value() == true);
+                    REQUIRE(popReturnValue.value() == i);
+                }
+            }
+        }
+    }
+
+    GIVEN("A BuRiTTO with a dynamic capacity") {
+        using BuRiTTO = BuRiTTO<DataType, BURITTO_DYNAMIC_CAPACITY>;
+        constexpr uint32_t ContainerCapacity {1024};
+
+        WHEN("the memory is allocated with hugepages") {
+            auto memory = QueueMemory::allocate(BuRiTTO::requiredMemorySize(ContainerCapacity), PageSize::HUGE_2MIB);
+
+            THEN("the memory should be usable for the BuRiTTO") {
+                REQUIRE(memory.has_value() == true);
+                REQUIRE(memory->numa_node() == QueueMemory::NO_NUMA_NODE);
+
+                BuRiTTO  buritto(ContainerCapacity, memory->get());
+                DataType outValue {0};
+                REQUIRE(buritto.push(42, outValue) == true);
+                REQUIRE(buritto.pop(outValue) == true);
+                REQUIRE(outValue == 42);
+            }
+        }
+    }
+}
+
+namespace {
+double benchmarkPageSize(PageSize pageSize, PageSize& usedPageSize) {
+    // 512 MiB of data and a producer which is half of the ring ahead of the consumer
+    constexpr uint64_t ContainerCapacity {1ULL << 26};
+    constexpr uint64_t NUMBER_OF_TRANSFERS {ContainerCapacity * 2};
+    constexpr uint64_t DISTANCE {ContainerCapacity / 2};
+    using DataType = uint64_t;
+    using RoQueT   = RoQueT<DataType, DYNAMIC_CAPACITY>;
+
+    auto memory = QueueMemory::allocate(RoQueT::required_memory_size(ContainerCapacity), pageSize, QueueMemory::current_numa_node());
+    if (!memory.has_value()) { return 0.; }
+    usedPageSize = memory->page_size();
+
+    RoQueT roquet(ContainerCapacity, memory->get());
+    auto   producer = roquet.producer();
+    auto   consumer = roquet.consumer();
+
+    return benchmarkThrottledTransfer(
+        NUMBER_OF_TRANSFERS, DISTANCE, [&](DataType data) { producer.push(data); }, [&] { return consumer.pop().has_value(); });
+}
+} // namespace
+
+TEST_CASE("QueueMemory - Page size benchmark", "[!benchmark]") {
+    std::cout << "requested page size \tused page size \ttransfer [ns]" << std::endl;
+    for (auto pageSize : {PageSize::REGULAR, PageSize::HUGE_2MIB, PageSize::HUGE_1GIB}) {
+        PageSize usedPageSize {PageSize::REGULAR};
+        auto     transferTime = benchmarkPageSize(pageSize, usedPageSize);
+        std::cout << QueueMemory::page_size_in_bytes(pageSize) << " \t" << QueueMemory::page_size_in_bytes(usedPageSize) << " \t"
+                  << transferTime << std::endl;
+    }
+}
@@ -2,14 +2,18 @@
 // SPDX-FileCopyrightText: © 2023 Mathias Kraus <elboberido@m-hias.de>
 
 #include "roquet.hpp"
+#include "transfer_benchmark.hpp"
 
 #define CATCH_CONFIG_ENABLE_BENCHMARKING
 #include "catch.hpp"
 
 #include <condition_variable>
+#include <cstdlib>
 #include <iostream>
+#include <memory>
 #include <mutex>
 #include <thread>
+#include <vector>
 
 SCENARIO("RoQuet - Unittest") {
     constexpr std::uint32_t ContainerCapacity {10};
@@ -60,6 +64,195 @@ SCENARIO("RoQuet - Unittest") {
             }
         }
 
+        WHEN("pushing a batch of data") {
+            constexpr uint64_t    BatchSize {5};
+            DataType              batch[BatchSize] {0, 1, 2, 3, 4};
+            std::vector<DataType> overflowData;
+            auto                  pushStatus = producer.push_batch(batch, BatchSize, [&](const DataType& data) { overflowData.push_back(data); });
+
+            THEN("it should not overflow and pop the data in order") {
+                REQUIRE(pushStatus == PushStatus::PUSHED);
+                REQUIRE(overflowData.empty());
+                REQUIRE(producer.empty() == false);
+                REQUIRE(consumer.empty() == false);
+                for (auto data : batch) {
+                    auto popReturnValue = consumer.pop();
+                    REQUIRE(popReturnValue.has_value() == true);
+                    REQUIRE(popReturnValue.value() == data);
+                }
+                REQUIRE(consumer.empty() == true);
+                REQUIRE(consumer.pop().has_value() == false);
+            }
+        }
+
+        WHEN("loaning a slot and committing it") {
+            constexpr DataType DATA {42};
+            auto               loanResult = producer.loan();
+            REQUIRE(loanResult.status == PushStatus::PUSHED);
+            auto& loan = loanResult.loan;
+            REQUIRE(loan.has_value() == true);
+            REQUIRE(loan->overflow() == nullptr);
+            **loan = DATA;
+
+            THEN("the data should not be visible before the commit") {
+                REQUIRE(consumer.empty() == true);
+                REQUIRE(consumer.pop().has_value() == false);
+
+                producer.commit(*loan);
+                REQUIRE(consumer.empty() == false);
+                auto popReturnValue = consumer.pop();
+                REQUIRE(popReturnValue.has_value() == true);
+                REQUIRE(popReturnValue.value() == DATA);
+                REQUIRE(consumer.empty() == true);
+            }
+        }
+
+        WHEN("loaning slots until the queue overflows") {
+            constexpr uint64_t    NumberOfLoans {ContainerCapacity + 3};
+            std::vector<DataType> overflowData;
+            for (DataType i = 0; i < NumberOfLoans; ++i) {
+                auto  loanResult = producer.loan();
+                auto& loan       = loanResult.loan;
+                REQUIRE(loan.has_value() == true);
+                REQUIRE((loanResult.status == PushStatus::OVERFLOWED) == (loan->overflow() != nullptr));
+                if (loan->overflow() != nullptr) { overflowData.push_back(*loan->overflow()); }
+                **loan = i;
+                producer.commit(*loan);
+            }
+
+            THEN("the overflowed data should be passed to the producer and the remaining data should be popped in order") {
+                REQUIRE(overflowData.size() == 2);
+                REQUIRE(overflowData[0] == 0);
+                REQUIRE(overflowData[1] == 1);
+                for (DataType i = 2; i < NumberOfLoans; ++i) {
+                    auto popReturnValue = consumer.pop();
+                    REQUIRE(popReturnValue.has_value() == true);
+                    REQUIRE(popReturnValue.value() == i);
+                }
+                REQUIRE(consumer.empty() == true);
+            }
+        }
+
+        WHEN("borrowing data") {
+            constexpr DataType DATA {42};
+            producer.push(DATA);
+            producer.push(DATA + 1);
+            auto borrow = consumer.borrow();
+
+            THEN("the data should be accessible in place and claimed by the release") {
+                REQUIRE(borrow.has_value() == true);
+                REQUIRE(**borrow == DATA);
+                REQUIRE(consumer.release(*borrow) == true);
+                auto popReturnValue = consumer.pop();
+                REQUIRE(popReturnValue.has_value() == true);
+                REQUIRE(popReturnValue.value() == DATA + 1);
+                REQUIRE(consumer.empty() == true);
+                REQUIRE(consumer.borrow().has_value() == false);
+            }
+        }
+
+        WHEN("the producer overwrites borrowed data") {
+            for (DataType i = 0; i <= ContainerCapacity; ++i) {
+                producer.push(i);
+            }
+            auto borrow = consumer.borrow();
+            REQUIRE(borrow.has_value() == true);
+            REQUIRE(**borrow == 0);
+            auto pushReturnValue = producer.push(ContainerCapacity + 1);
+
+            THEN("the release should fail and the next borrow should continue with the oldest data and report the overflow") {
+                REQUIRE(pushReturnValue.has_value() == true);
+                REQUIRE(pushReturnValue.value() == 0);
+                REQUIRE(borrow->status() == PopStatus::DATA);
+                REQUIRE(consumer.release(*borrow) == false);
+                for (DataType i = 1; i <= ContainerCapacity + 1; ++i) {
+                    auto nextBorrow = consumer.borrow();
+                    REQUIRE(nextBorrow.has_value() == true);
+                    REQUIRE(**nextBorrow == i);
+                    REQUIRE(nextBorrow->status() == (i == 1 ? PopStatus::OVERFLOW_RECOVERED : PopStatus::DATA));
+                    REQUIRE(nextBorrow->lost() == (i == 1 ? 1 : 0));
+                    REQUIRE(consumer.release(*nextBorrow) == true);
+                }
+                REQUIRE(consumer.empty() == true);
+            }
+        }
+
+        WHEN("the END with the OVERFLOW flag reaches the head position between the borrow and the release") {
+            producer.push(0);
+            auto borrow = consumer.borrow();
+            REQUIRE(borrow.has_value() == true);
+            REQUIRE(**borrow == 0);
+            // the END is advanced over the borrowed data and wraps around to the head position
+            constexpr DataType NumberOfPushes {2 * ContainerCapacity + 2};
+            for (DataType i = 1; i <= NumberOfPushes; ++i) {
+                producer.push(i);
+            }
+
+            THEN("the release should fail and the next pop should report the lost elements although the release reset the OVERFLOW flag") {
+                REQUIRE(consumer.release(*borrow) == false);
+                auto popResult = consumer.pop_checked();
+                REQUIRE(popResult.status == PopStatus::OVERFLOW_RECOVERED);
+                REQUIRE(popResult.data.value() == NumberOfPushes + 1 - (ContainerCapacity + 1));
+                REQUIRE(popResult.lost == NumberOfPushes + 1 - (ContainerCapacity + 1));
+            }
+        }
+
+        WHEN("popping a batch of data") {
+            constexpr uint64_t NumberOfPushes {7};
+            for (auto i = 0u; i < NumberOfPushes; ++i) {
+                producer.push(i);
+            }
+
+            constexpr uint64_t BatchSize {5};
+            DataType           batch[BatchSize];
+            auto               numberOfPops = consumer.pop_batch(batch, BatchSize);
+
+            THEN("it should pop at most the requested amount of data in order") {
+                REQUIRE(numberOfPops == BatchSize);
+                for (auto i = 0u; i < BatchSize; ++i) {
+                    REQUIRE(batch[i] == i);
+                }
+                REQUIRE(consumer.empty() == false);
+            }
+
+            AND_WHEN("popping another batch") {
+                numberOfPops = consumer.pop_batch(batch, BatchSize);
+
+                THEN("it should pop the remaining data and be empty") {
+                    REQUIRE(numberOfPops == NumberOfPushes - BatchSize);
+                    REQUIRE(batch[0] == BatchSize);
+                    REQUIRE(batch[1] == BatchSize + 1);
+                    REQUIRE(consumer.empty() == true);
+                    REQUIRE(consumer.pop_batch(batch, BatchSize) == 0);
+                }
+            }
+        }
+
+        WHEN("pushing a batch which is larger than the capacity") {
+            constexpr uint64_t    BatchSize {ContainerCapacity * 2 + 5};
+            constexpr uint64_t    QueueSize {ContainerCapacity + 1};
+            DataType              batch[BatchSize];
+            std::vector<DataType> overflowData;
+            for (auto i = 0u; i < BatchSize; ++i) {
+                batch[i] = i;
+            }
+            auto pushStatus = producer.push_batch(batch, BatchSize, [&](const DataType& data) { overflowData.push_back(data); });
+
+            THEN("it should return the oldest data and pop the remaining data in order") {
+                REQUIRE(pushStatus == PushStatus::OVERFLOWED);
+                REQUIRE(overflowData.size() == BatchSize - QueueSize);
+                for (auto i = 0u; i < overflowData.size(); ++i) {
+                    REQUIRE(overflowData[i] == i);
+                }
+                for (auto i = BatchSize - QueueSize; i < BatchSize; ++i) {
+                    auto popReturnValue = consumer.pop();
+                    REQUIRE(popReturnValue.has_value() == true);
+                    REQUIRE(popReturnValue.value() == i);
+                }
+                REQUIRE(consumer.empty() == true);
+            }
+        }
+
         WHEN("filling the roquet to the point before overrun") {
             std::optional<DataType> pushReturnValue;
             bool                    producerEmptyReturnValue {false};
@@ -97,6 +290,46 @@ SCENARIO("RoQuet - Unittest") {
 
                 dataCounter++;
 
+                AND_WHEN("pushing a batch of data") {
+                    constexpr uint64_t    BatchSize {3};
+                    DataType              batch[BatchSize] {pushCounter, pushCounter + 1, pushCounter + 2};
+                    std::vector<DataType> overflowData;
+                    producer.push_batch(batch, BatchSize, [&](const DataType& data) { overflowData.push_back(data); });
+                    pushCounter += BatchSize;
+
+                    THEN("it should return the oldest data and pop the remaining data in order") {
+                        REQUIRE(overflowData.size() == BatchSize);
+                        for (auto data : overflowData) {
+                            REQUIRE(data == dataCounter);
+                            dataCounter++;
+                        }
+                        while (dataCounter < pushCounter) {
+                            auto popReturnValue = consumer.pop();
+                            REQUIRE(popReturnValue.has_value() == true);
+                            REQUIRE(popReturnValue.value() == dataCounter);
+                            dataCounter++;
+                        }
+                        REQUIRE(consumer.empty() == true);
+                    }
+                }
+
+                AND_WHEN("draining the roquet") {
+                    std::vector<DataType> drainData;
+                    auto numberOfPops = consumer.drain([&](const DataType& data) { drainData.push_back(data); });
+
+                    THEN("it should pop all data in order and be empty") {
+                        REQUIRE(numberOfPops == ContainerCapacity + ExtraCapacity);
+                        REQUIRE(drainData.size() == ContainerCapacity + ExtraCapacity);
+                        for (auto data : drainData) {
+                            REQUIRE(data == dataCounter);
+                            dataCounter++;
+                        }
+                        REQUIRE(dataCounter == pushCounter);
+                        REQUIRE(producer.empty() == true);
+                        REQUIRE(consumer.empty() == true);
+                    }
+                }
+
                 AND_WHEN("pop all data out") {
                     std::optional<DataType> popReturnValue;
                     for (auto i = 0u; i < ContainerCapacity + ExtraCapacity; i++) {
@@ -132,6 +365,586 @@ SCENARIO("RoQuet - Unittest") {
     }
 }
 
+SCENARIO("RoQueT - Checked operations") {
+    constexpr std::uint32_t ContainerCapacity {10};
+    constexpr std::uint32_t QueueSize {ContainerCapacity + 1};
+    using DataType = size_t;
+    using RoQueT   = RoQueT<DataType, DYNAMIC_CAPACITY>;
+
+    // the memory is provided by the test to be able to corrupt the states
+    std::vector<uint64_t> memory((RoQueT::required_memory_size(ContainerCapacity) + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+    auto                  states = reinterpret_cast<std::atomic<uint8_t>*>(memory.data());
+
+    GIVEN("A RoQueT") {
+        RoQueT roquet(ContainerCapacity, memory.data());
+        auto   producer = roquet.producer();
+        auto   consumer = roquet.consumer();
+
+        WHEN("the roquet is empty") {
+            THEN("the pop should report an empty queue") {
+                auto popResult = consumer.pop_checked();
+                REQUIRE(popResult.status == PopStatus::EMPTY);
+                REQUIRE(popResult.data.has_value() == false);
+            }
+        }
+
+        WHEN("pushing data without overflow") {
+            auto pushResult = producer.push_checked(42);
+
+            THEN("the push and the pop should report the data") {
+                REQUIRE(pushResult.status == PushStatus::PUSHED);
+                REQUIRE(pushResult.overflow.has_value() == false);
+
+                auto popResult = consumer.pop_checked();
+                REQUIRE(popResult.status == PopStatus::DATA);
+                REQUIRE(popResult.data.value() == 42);
+            }
+        }
+
+        WHEN("overflowing the roquet") {
+            for (DataType i = 0; i < QueueSize; ++i) {
+                REQUIRE(producer.push_checked(i).status == PushStatus::PUSHED);
+            }
+            auto pushResult = producer.push_checked(QueueSize);
+
+            THEN("the push should report the overflow and the pop should report the recovery only once") {
+                REQUIRE(pushResult.status == PushStatus::OVERFLOWED);
+                REQUIRE(pushResult.overflow.value() == 0);
+
+                auto popResult = consumer.pop_checked();
+                REQUIRE(popResult.status == PopStatus::OVERFLOW_RECOVERED);
+                REQUIRE(popResult.data.value() == 1);
+                REQUIRE(popResult.lost == 1);
+                for (DataType i = 2; i <= QueueSize; ++i) {
+                    popResult = consumer.pop_checked();
+                    REQUIRE(popResult.status == PopStatus::DATA);
+                    REQUIRE(popResult.data.value() == i);
+                }
+                REQUIRE(consumer.pop_checked().status == PopStatus::EMPTY);
+            }
+        }
+
+        WHEN("there are further END flags behind the tail position") {
+            producer.push(42);
+            // the tail position starts at 1 and is 2 after the push; a batch of three elements advances the END flag to position 5
+            states[3].store(RoQueT::END, std::memory_order_relaxed);
+            states[5].store(RoQueT::END, std::memory_order_relaxed);
+
+            THEN("the push, the loan and the batch push should report a corrupted queue and not advance the tail position") {
+                auto pushResult = producer.push_checked(73);
+                REQUIRE(pushResult.status == PushStatus::CORRUPT);
+                REQUIRE(pushResult.overflow.has_value() == false);
+
+                auto loanResult = producer.loan();
+                REQUIRE(loanResult.status == PushStatus::CORRUPT);
+                REQUIRE(loanResult.loan.has_value() == false);
+
+                DataType batch[] {1, 2, 3};
+                uint64_t overflowCounter {0};
+                REQUIRE(producer.push_batch(batch, 3, [&](const DataType&) { ++overflowCounter; }) == PushStatus::CORRUPT);
+                REQUIRE(overflowCounter == 0);
+
+                REQUIRE(consumer.pop().value() == 42);
+                REQUIRE(consumer.pop().has_value() == false);
+            }
+        }
+
+        WHEN("the END flag was lost") {
+            producer.push(42);
+            for (uint32_t i = 0; i < ContainerCapacity + 2; ++i) {
+                states[i].store(RoQueT::DATA, std::memory_order_relaxed);
+            }
+
+            THEN("the pop should report a corrupted queue instead of an empty one") {
+                auto popResult = consumer.pop_checked();
+                REQUIRE(popResult.status == PopStatus::CORRUPT);
+                REQUIRE(popResult.data.has_value() == false);
+                REQUIRE(consumer.pop().has_value() == false);
+            }
+        }
+
+        WHEN("the END flag was lost and the consumer has a budget of one wrap-around") {
+            consumer.set_wrap_around_budget(1);
+            producer.push(42);
+            for (uint32_t i = 0; i < ContainerCapacity + 2; ++i) {
+                states[i].store(RoQueT::DATA, std::memory_order_relaxed);
+            }
+
+            THEN("the search should be continued by the next pops until the corruption is detected") {
+                REQUIRE(consumer.pop_checked().status == PopStatus::RETRY_BUDGET_EXHAUSTED);
+                REQUIRE(consumer.pop_checked().status == PopStatus::RETRY_BUDGET_EXHAUSTED);
+                REQUIRE(consumer.pop_checked().status == PopStatus::CORRUPT);
+            }
+        }
+
+        WHEN("the END flag was lost and the search was started by borrows") {
+            consumer.set_wrap_around_budget(1);
+            producer.push(42);
+            for (uint32_t i = 0; i < ContainerCapacity + 2; ++i) {
+                states[i].store(RoQueT::DATA, std::memory_order_relaxed);
+            }
+
+            THEN("the pop should continue the corruption detection of the borrows") {
+                REQUIRE(consumer.borrow().has_value() == false);
+                REQUIRE(consumer.borrow().has_value() == false);
+                REQUIRE(consumer.pop_checked().status == PopStatus::CORRUPT);
+            }
+        }
+
+        WHEN("overflowing the roquet multiple times with a budget of one wrap-around") {
+            consumer.set_wrap_around_budget(1);
+            constexpr DataType NumberOfPushes {3 * QueueSize + 5};
+            for (DataType i = 0; i < NumberOfPushes; ++i) {
+                producer.push(i);
+            }
+
+            THEN("the pop should recover from the overflow") {
+                auto popResult = consumer.pop_checked();
+                REQUIRE(popResult.status == PopStatus::OVERFLOW_RECOVERED);
+                REQUIRE(popResult.data.value() == NumberOfPushes - QueueSize);
+                REQUIRE(popResult.lost == NumberOfPushes - QueueSize);
+            }
+        }
+
+        WHEN("the END did a full wrap-around with overflows and is back at the head position of the consumer") {
+            // this looks like a full queue without overflow unless the END has the OVERFLOW flag
+            constexpr DataType NumberOfPushes {2 * QueueSize + 1};
+            for (DataType i = 0; i < NumberOfPushes; ++i) {
+                producer.push(i);
+            }
+
+            THEN("the pop should report the lost elements") {
+                auto popResult = consumer.pop_checked();
+                REQUIRE(popResult.status == PopStatus::OVERFLOW_RECOVERED);
+                REQUIRE(popResult.data.value() == NumberOfPushes - QueueSize);
+                REQUIRE(popResult.lost == NumberOfPushes - QueueSize);
+
+                AND_THEN("the next pops should not report the overflow again") {
+                    popResult = consumer.pop_checked();
+                    REQUIRE(popResult.status == PopStatus::DATA);
+                    REQUIRE(popResult.lost == 0);
+                }
+            }
+        }
+
+        WHEN("the data was pushed to the END with the OVERFLOW flag at the head position of the consumer") {
+            constexpr DataType NumberOfPushes {2 * QueueSize + 2};
+            for (DataType i = 0; i < NumberOfPushes; ++i) {
+                producer.push(i);
+            }
+
+            THEN("the pop should report the lost elements") {
+                auto popResult = consumer.pop_checked();
+                REQUIRE(popResult.status == PopStatus::OVERFLOW_RECOVERED);
+                REQUIRE(popResult.data.value() == NumberOfPushes - QueueSize);
+                REQUIRE(popResult.lost == NumberOfPushes - QueueSize);
+            }
+        }
+
+        WHEN("a batch is pushed over the END with the OVERFLOW flag at the head position of the consumer and over a full roquet") {
+            constexpr DataType NumberOfPushes {2 * QueueSize + 1};
+            for (DataType i = 0; i < NumberOfPushes; ++i) {
+                producer.push(i);
+            }
+            // the END with the OVERFLOW flag is at the head position 0 and the batch overruns the positions 1 to 3
+            constexpr uint64_t BatchSize {3};
+            DataType           batch[] {100, 101, 102};
+            uint64_t           overflowCounter {0};
+            REQUIRE(producer.push_batch(batch, BatchSize, [&](const DataType&) { ++overflowCounter; }) == PushStatus::OVERFLOWED);
+
+            THEN("the published batch should keep the OVERFLOW flags and the pop should report the lost elements") {
+                REQUIRE(overflowCounter == BatchSize);
+                for (uint32_t i = 0; i < BatchSize; ++i) {
+                    REQUIRE(states[i].load(std::memory_order_relaxed) == (RoQueT::DATA | RoQueT::OVERFLOW));
+                }
+
+                auto popResult = consumer.pop_checked();
+                REQUIRE(popResult.status == PopStatus::OVERFLOW_RECOVERED);
+                REQUIRE(popResult.data.value() == NumberOfPushes - QueueSize + BatchSize);
+                REQUIRE(popResult.lost == NumberOfPushes - QueueSize + BatchSize);
+            }
+        }
+
+        WHEN("the queue is full without overflow") {
+            for (DataType i = 0; i < QueueSize; ++i) {
+                producer.push(i);
+            }
+
+            THEN("the pop should not report an overflow") {
+                auto popResult = consumer.pop_checked();
+                REQUIRE(popResult.status == PopStatus::DATA);
+                REQUIRE(popResult.data.value() == 0);
+            }
+        }
+    }
+}
+
+TEST_CASE("RoQueT - Search budget") {
+    constexpr std::uint32_t ContainerCapacity {62};
+    constexpr std::uint32_t InternalCapacity {ContainerCapacity + 2};
+    constexpr std::uint32_t EndDistance {8};
+    using DataType = size_t;
+    using RoQueT   = RoQueT<DataType, DYNAMIC_CAPACITY, PackedLayout, OperationStatistics>;
+
+    std::vector<uint64_t> memory((RoQueT::required_memory_size(ContainerCapacity) + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+    auto                  states = reinterpret_cast<std::atomic<uint8_t>*>(memory.data());
+
+    RoQueT roquet(ContainerCapacity, memory.data());
+    auto   consumer = roquet.consumer();
+    consumer.set_wrap_around_budget(1);
+
+    // each END is followed by a PENDING, therefore the search jumps from one END candidate to the next one without finding the new head
+    for (uint32_t i = 0; i < InternalCapacity; ++i) {
+        auto state = i % EndDistance == 0 ? RoQueT::END : (i % EndDistance == 1 ? RoQueT::PENDING : RoQueT::DATA);
+        states[i].store(state, std::memory_order_relaxed);
+    }
+
+    // the positions which were skipped by the jumps count against the budget of one wrap-around
+    REQUIRE(consumer.pop_checked().status == PopStatus::RETRY_BUDGET_EXHAUSTED);
+    REQUIRE(roquet.counters().popRetries < InternalCapacity / EndDistance);
+}
+
+SCENARIO("RoQueT - Statistics") {
+    constexpr std::uint32_t ContainerCapacity {10};
+    constexpr std::uint32_t QueueSize {ContainerCapacity + 1};
+    using DataType = size_t;
+    using RoQueT   = RoQueT<DataType, ContainerCapacity, PackedLayout, OperationStatistics>;
+
+    GIVEN("A RoQueT with statistics") {
+        auto roquet   = std::make_unique<RoQueT>();
+        auto producer = roquet->producer();
+        auto consumer = roquet->consumer();
+
+        WHEN("the roquet was just created") {
+            REQUIRE(consumer.pop().has_value() == false);
+
+            THEN("all counters should be zero") {
+                auto counters = roquet->counters();
+                REQUIRE(counters.pushes == 0);
+                REQUIRE(counters.overflows == 0);
+                REQUIRE(counters.pops == 0);
+                REQUIRE(counters.popRetries == 0);
+                REQUIRE(counters.casFailures == 0);
+            }
+        }
+
+        WHEN("pushing and popping data without overflow") {
+            for (DataType i = 0; i < QueueSize; ++i) {
+                producer.push(i);
+            }
+            while (consumer.pop().has_value()) {}
+
+            THEN("the pushes and pops should be counted without retries") {
+                auto counters = roquet->counters();
+                REQUIRE(counters.pushes == QueueSize);
+                REQUIRE(counters.overflows == 0);
+                REQUIRE(counters.pops == QueueSize);
+                REQUIRE(counters.popRetries == 0);
+                REQUIRE(counters.casFailures == 0);
+            }
+        }
+
+        WHEN("overflowing the roquet with single and batch pushes") {
+            constexpr DataType NumberOfPushes {QueueSize + 2};
+            DataType           batch[] {NumberOfPushes, NumberOfPushes + 1, NumberOfPushes + 2};
+            for (DataType i = 0; i < NumberOfPushes; ++i) {
+                producer.push(i);
+            }
+            producer.push_batch(batch, 3, [](const DataType&) {});
+
+            THEN("the overflows and the retries of the recovery should be counted") {
+                REQUIRE(consumer.drain([](const DataType&) {}) == QueueSize);
+
+                auto counters = roquet->counters();
+                REQUIRE(counters.pushes == NumberOfPushes + 3);
+                REQUIRE(counters.overflows == NumberOfPushes + 3 - QueueSize);
+                REQUIRE(counters.pops == QueueSize);
+                REQUIRE(counters.popRetries > 0);
+                REQUIRE(counters.casFailures == 0);
+            }
+        }
+    }
+}
+
+TEMPLATE_TEST_CASE("RoQueT - Layouts", "", PackedLayout, PaddedLayout, InterleavedLayout) {
+    constexpr std::uint32_t ContainerCapacity {10};
+    constexpr std::uint32_t QueueSize {ContainerCapacity + 1};
+    using DataType = size_t;
+    using RoQueT   = RoQueT<DataType, ContainerCapacity, TestType>;
+
+    RoQueT roquet;
+    auto   producer = roquet.producer();
+    auto   consumer = roquet.consumer();
+
+    constexpr DataType NumberOfPushes {QueueSize + 3};
+    DataType           overrunCounter {0};
+    for (DataType i = 0; i < NumberOfPushes; ++i) {
+        auto pushReturnValue = producer.push(i);
+        if (pushReturnValue.has_value()) {
+            REQUIRE(pushReturnValue.value() == overrunCounter);
+            ++overrunCounter;
+        }
+    }
+    REQUIRE(overrunCounter == NumberOfPushes - QueueSize);
+
+    for (DataType i = overrunCounter; i < NumberOfPushes; ++i) {
+        auto popReturnValue = consumer.pop();
+        REQUIRE(popReturnValue.has_value() == true);
+        REQUIRE(popReturnValue.value() == i);
+    }
+    REQUIRE(consumer.empty() == true);
+    REQUIRE(producer.empty() == true);
+}
+
+TEMPLATE_TEST_CASE("RoQueT - Dynamic capacity", "", PackedLayout, PaddedLayout, InterleavedLayout) {
+    using DataType = size_t;
+    using RoQueT   = RoQueT<DataType, DYNAMIC_CAPACITY, TestType>;
+
+    // a power of two and a non power of two capacity
+    const uint64_t ContainerCapacity = GENERATE(10, 16);
+    const uint64_t QueueSize {ContainerCapacity + 1};
+
+    auto   memory = std::unique_ptr<void, decltype(&std::free)>(
+        std::aligned_alloc(RoQueT::memory_alignment(), alignUp(RoQueT::required_memory_size(ContainerCapacity), RoQueT::memory_alignment())),
+        &std::free);
+    RoQueT roquet(ContainerCapacity, memory.get());
+    auto   producer = roquet.producer();
+    auto   consumer = roquet.consumer();
+    REQUIRE(roquet.capacity() == ContainerCapacity);
+
+    const DataType NumberOfPushes {QueueSize * 2 + 3};
+    DataType       overrunCounter {0};
+    for (DataType i = 0; i < NumberOfPushes; ++i) {
+        auto pushReturnValue = producer.push(i);
+        if (pushReturnValue.has_value()) {
+            REQUIRE(pushReturnValue.value() == overrunCounter);
+            ++overrunCounter;
+        }
+    }
+    REQUIRE(overrunCounter == NumberOfPushes - QueueSize);
+
+    for (DataType i = overrunCounter; i < NumberOfPushes; ++i) {
+        auto popReturnValue = consumer.pop();
+        REQUIRE(popReturnValue.has_value() == true);
+        REQUIRE(popReturnValue.value() == i);
+    }
+    REQUIRE(consumer.empty() == true);
+    REQUIRE(producer.empty() == true);
+}
+
+TEST_CASE("RoQueT - Blocking pop") {
+    constexpr std::uint32_t ContainerCapacity {10};
+    using DataType = size_t;
+    using RoQueT   = RoQueT<DataType, ContainerCapacity, PackedLayout, NoStatistics, true>;
+
+    RoQueT roquet;
+    auto   producer = roquet.producer();
+    auto   consumer = roquet.consumer();
+
+    SECTION("pop_wait on an empty queue times out") {
+        auto startTime      = std::chrono::steady_clock::now();
+        auto popReturnValue = consumer.pop_wait(std::chrono::milliseconds(10));
+        REQUIRE(popReturnValue.has_value() == false);
+        REQUIRE(std::chrono::steady_clock::now() - startTime >= std::chrono::milliseconds(10));
+    }
+
+    SECTION("pop_wait returns available data immediately") {
+        producer.push(42);
+        auto popReturnValue = consumer.pop_wait(std::chrono::seconds(10));
+        REQUIRE(popReturnValue.has_value() == true);
+        REQUIRE(popReturnValue.value() == 42);
+    }
+
+    SECTION("pop_wait is woken up by a push") {
+        auto pushThread = std::thread([&] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            producer.push(13);
+        });
+
+        auto popReturnValue = consumer.pop_wait(std::chrono::seconds(10));
+        pushThread.join();
+        REQUIRE(popReturnValue.has_value() == true);
+        REQUIRE(popReturnValue.value() == 13);
+    }
+}
+
+SCENARIO("RoQueT - Cancellation") {
+    constexpr std::uint32_t ContainerCapacity {10};
+    constexpr std::uint32_t QueueSize {ContainerCapacity + 1};
+    constexpr std::uint32_t InternalCapacity {ContainerCapacity + 2};
+    using DataType     = size_t;
+    using RoQueT       = RoQueT<DataType, ContainerCapacity>;
+    using CancelHandle = RoQueT::CancelHandle;
+
+    GIVEN("A RoQueT with cancellable data") {
+        auto roquet   = std::make_unique<RoQueT>();
+        auto producer = roquet->producer();
+        auto consumer = roquet->consumer();
+
+        CancelHandle handles[QueueSize];
+        for (DataType i = 0; i < 5; ++i) {
+            REQUIRE(producer.push_cancellable(i, handles[i]).status == PushStatus::PUSHED);
+        }
+
+        WHEN("canceling data in the middle") {
+            REQUIRE(producer.cancel(handles[2]) == true);
+
+            THEN("it cannot be canceled again and the pop should skip it") {
+                REQUIRE(producer.cancel(handles[2]) == false);
+                for (DataType i : {0, 1, 3, 4}) {
+                    auto popReturnValue = consumer.pop();
+                    REQUIRE(popReturnValue.has_value() == true);
+                    REQUIRE(popReturnValue.value() == i);
+                }
+                REQUIRE(consumer.pop().has_value() == false);
+            }
+
+            THEN("drain should skip it") {
+                std::vector<DataType> popData;
+                REQUIRE(consumer.drain([&](const DataType& data) { popData.push_back(data); }) == 4);
+                REQUIRE(popData == std::vector<DataType> {0, 1, 3, 4});
+            }
+
+            THEN("borrow should skip it") {
+                for (DataType i : {0, 1, 3, 4}) {
+                    auto borrow = consumer.borrow();
+                    REQUIRE(borrow.has_value() == true);
+                    REQUIRE(**borrow == i);
+                    REQUIRE(consumer.release(*borrow) == true);
+                }
+                REQUIRE(consumer.borrow().has_value() == false);
+            }
+        }
+
+        WHEN("canceling all data") {
+            for (DataType i = 0; i < 5; ++i) {
+                REQUIRE(producer.cancel(handles[i]) == true);
+            }
+
+            THEN("the roquet should be empty and usable afterwards") {
+                REQUIRE(consumer.pop().has_value() == false);
+                REQUIRE(consumer.empty() == true);
+                producer.push(42);
+                auto popReturnValue = consumer.pop();
+                REQUIRE(popReturnValue.has_value() == true);
+                REQUIRE(popReturnValue.value() == 42);
+            }
+        }
+
+        WHEN("the data was already popped or is inspected") {
+            REQUIRE(consumer.pop().value() == 0);
+            auto borrow = consumer.borrow();
+            REQUIRE(borrow.has_value() == true);
+
+            THEN("it cannot be canceled") {
+                REQUIRE(producer.cancel(handles[0]) == false);
+                REQUIRE(producer.cancel(handles[1]) == false);
+                REQUIRE(consumer.release(*borrow) == true);
+            }
+        }
+
+        WHEN("the position of the handle was reused by a later push") {
+            while (consumer.pop().has_value()) {}
+            // the data of the handle was popped and the position holds new data after a wrap-around
+            for (DataType i = 5; i < InternalCapacity + 1; ++i) {
+                producer.push(i);
+                if (i < InternalCapacity) { REQUIRE(consumer.pop().value() == i); }
+            }
+
+            THEN("the handle should be rejected") {
+                REQUIRE(producer.cancel(handles[1]) == false);
+                auto popReturnValue = consumer.pop();
+                REQUIRE(popReturnValue.has_value() == true);
+                REQUIRE(popReturnValue.value() == InternalCapacity);
+            }
+        }
+
+        WHEN("the producer wraps around over canceled data") {
+            for (DataType i = 5; i < QueueSize; ++i) {
+                REQUIRE(producer.push_cancellable(i, handles[i]).status == PushStatus::PUSHED);
+            }
+            REQUIRE(producer.cancel(handles[0]) == true);
+            auto pushResult = producer.push_checked(QueueSize);
+
+            THEN("the canceled data should not be returned as overflow and no data should be lost") {
+                REQUIRE(pushResult.status == PushStatus::PUSHED);
+                REQUIRE(pushResult.overflow.has_value() == false);
+                for (DataType i = 1; i <= QueueSize; ++i) {
+                    auto popReturnValue = consumer.pop();
+                    REQUIRE(popReturnValue.has_value() == true);
+                    REQUIRE(popReturnValue.value() == i);
+                }
+                REQUIRE(consumer.pop().has_value() == false);
+            }
+        }
+    }
+}
+
+TEST_CASE("RoQueT - Cancellation between threads") {
+    constexpr std::uint32_t ContainerCapacity {100};
+    constexpr uint64_t      NUMBER_OF_PUSHES {200000};
+    constexpr uint64_t      DISTANCE {ContainerCapacity / 2};
+    constexpr uint64_t      CANCEL_DELAY {5};
+    using DataType = uint64_t;
+    using RoQueT   = RoQueT<DataType, ContainerCapacity>;
+
+    auto roquet   = std::make_unique<RoQueT>();
+    auto producer = roquet->producer();
+    auto consumer = roquet->consumer();
+
+    // the producer stays at most half of the capacity ahead of the consumer, therefore nothing overflows and each element is either
+    // popped or canceled
+    std::atomic<uint64_t> lastPopped {0};
+    std::atomic<bool>     pushFinished {false};
+    std::vector<bool>     canceled(NUMBER_OF_PUSHES, false);
+    std::vector<bool>     popped(NUMBER_OF_PUSHES, false);
+
+    auto pushThread = std::thread([&] {
+        std::vector<RoQueT::CancelHandle> handles(NUMBER_OF_PUSHES);
+        for (DataType i = 0; i < NUMBER_OF_PUSHES; ++i) {
+            while (i - lastPopped.load(std::memory_order_relaxed) > DISTANCE) {
+                std::this_thread::yield();
+            }
+            producer.push_cancellable(i, handles[i]);
+            // cancel the current element and an older one which might just be popped
+            if (i % 3 == 0) { canceled[i] = producer.cancel(handles[i]); }
+            if (i % 3 == 1 && i >= CANCEL_DELAY) { canceled[i - CANCEL_DELAY] = producer.cancel(handles[i - CANCEL_DELAY]); }
+        }
+        pushFinished.store(true, std::memory_order_release);
+    });
+
+    bool     inOrder {true};
+    uint64_t previous {0};
+    bool     isFirst {true};
+    while (true) {
+        // the flag is loaded before the pop, therefore the queue is drained when the pop fails after the producer finished
+        auto isPushFinished = pushFinished.load(std::memory_order_acquire);
+        if (auto popReturnValue = consumer.pop()) {
+            inOrder &= isFirst || popReturnValue.value() > previous;
+            previous         = popReturnValue.value();
+            isFirst          = false;
+            popped[previous] = true;
+            lastPopped.store(previous, std::memory_order_relaxed);
+        } else if (isPushFinished) {
+            break;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+
+    pushThread.join();
+
+    REQUIRE(inOrder == true);
+    uint64_t numberOfMismatches {0};
+    uint64_t numberOfCanceled {0};
+    for (DataType i = 0; i < NUMBER_OF_PUSHES; ++i) {
+        if (popped[i] == canceled[i]) { ++numberOfMismatches; }
+        if (canceled[i]) { ++numberOfCanceled; }
+    }
+    REQUIRE(numberOfMismatches == 0);
+    REQUIRE(numberOfCanceled > 0);
+}
+
 TEST_CASE("RoQueT - Stress", "[.stress]") {
     constexpr std::uint32_t ContainerCapacity {10};
     using DataType = uint64_t;
@@ -284,3 +1097,220 @@ TEST_CASE("RoQueT - Stress", "[.stress]") {
     CHECK(NUMBER_OF_PUSHES == pushCounter);
     CHECK(pushCounter == (overrunCounter + popCounter));
 }
+
+TEST_CASE("RoQueT - Stress batch push", "[.stress]") {
+    constexpr std::uint32_t ContainerCapacity {10};
+    using DataType = uint64_t;
+    using RoQueT   = RoQueT<DataType, ContainerCapacity>;
+
+    constexpr uint64_t NUMBER_OF_PUSHES {1000000};
+    constexpr uint64_t BATCH_SIZE {4};
+    constexpr DataType COUNTER_START_VALUE {0};
+
+    DataType          pushCounter {COUNTER_START_VALUE};
+    std::atomic<bool> pushThreadFinished {false};
+
+    RoQueT roquet;
+    auto   producer = roquet.producer();
+    auto   consumer = roquet.consumer();
+
+    std::vector<DataType> overrunData;
+    std::vector<DataType> popData;
+    overrunData.reserve(NUMBER_OF_PUSHES);
+    popData.reserve(NUMBER_OF_PUSHES);
+
+    auto pushThread = std::thread([&] {
+        DataType batch[BATCH_SIZE];
+        while (pushCounter < NUMBER_OF_PUSHES) {
+            for (auto& data : batch) {
+                data = pushCounter++;
+            }
+            producer.push_batch(batch, BATCH_SIZE, [&](const DataType& data) { overrunData.push_back(data); });
+        }
+        pushThreadFinished = true;
+    });
+
+    auto popThread = std::thread([&] {
+        uint64_t failedPopsWhilePushThreadFinished {0};
+        while (!pushThreadFinished.load(std::memory_order_relaxed) || !consumer.empty()) {
+            auto retVal = consumer.pop();
+            if (retVal.has_value()) {
+                popData.push_back(retVal.value());
+            } else if (pushThreadFinished.load(std::memory_order_relaxed)) {
+                ++failedPopsWhilePushThreadFinished;
+                if (failedPopsWhilePushThreadFinished > ContainerCapacity * 2) { break; }
+            }
+        }
+    });
+
+    pushThread.join();
+    popThread.join();
+
+    std::cout << "batch push overrun counter \t" << overrunData.size() << std::endl;
+    std::cout << "batch push pop counter \t" << popData.size() << std::endl;
+
+    size_t overrunIndex = 0;
+    size_t popIndex     = 0;
+    bool   dataIntact   = true;
+    for (size_t i = COUNTER_START_VALUE; i < pushCounter; i++) {
+        if (overrunIndex < overrunData.size() && overrunData[overrunIndex] == i) {
+            overrunIndex++;
+        } else if (popIndex < popData.size() && popData[popIndex] == i) {
+            popIndex++;
+        } else {
+            std::cout << "data loss detected at index: " << i << std::endl;
+            dataIntact = false;
+            break;
+        }
+    }
+
+    CHECK(dataIntact);
+    CHECK(pushCounter == (overrunData.size() + popData.size()));
+}
+
+TEST_CASE("RoQueT - Stress batch push and drain", "[.stress]") {
+    constexpr std::uint32_t ContainerCapacity {10};
+    using DataType = uint64_t;
+    using RoQueT   = RoQueT<DataType, ContainerCapacity>;
+
+    constexpr uint64_t NUMBER_OF_PUSHES {1000000};
+    constexpr uint64_t BATCH_SIZE {4};
+    constexpr DataType COUNTER_START_VALUE {0};
+
+    DataType          pushCounter {COUNTER_START_VALUE};
+    std::atomic<bool> pushThreadFinished {false};
+
+    RoQueT roquet;
+    auto   producer = roquet.producer();
+    auto   consumer = roquet.consumer();
+
+    std::vector<DataType> overrunData;
+    std::vector<DataType> popData;
+    overrunData.reserve(NUMBER_OF_PUSHES);
+    popData.reserve(NUMBER_OF_PUSHES);
+
+    auto pushThread = std::thread([&] {
+        DataType batch[BATCH_SIZE];
+        while (pushCounter < NUMBER_OF_PUSHES) {
+            for (auto& data : batch) {
+                data = pushCounter++;
+            }
+            producer.push_batch(batch, BATCH_SIZE, [&](const DataType& data) { overrunData.push_back(data); });
+        }
+        pushThreadFinished = true;
+    });
+
+    auto popThread = std::thread([&] {
+        uint64_t failedPopsWhilePushThreadFinished {0};
+        while (!pushThreadFinished.load(std::memory_order_relaxed) || !consumer.empty()) {
+            auto numberOfPops = consumer.drain([&](const DataType& data) { popData.push_back(data); });
+            if (numberOfPops == 0 && pushThreadFinished.load(std::memory_order_relaxed)) {
+                ++failedPopsWhilePushThreadFinished;
+                if (failedPopsWhilePushThreadFinished > ContainerCapacity * 2) { break; }
+            }
+        }
+    });
+
+    pushThread.join();
+    popThread.join();
+
+    std::cout << "batch push overrun counter \t" << overrunData.size() << std::endl;
+    std::cout << "drain pop counter \t" << popData.size() << std::endl;
+
+    size_t overrunIndex = 0;
+    size_t popIndex     = 0;
+    bool   dataIntact   = true;
+    for (size_t i = COUNTER_START_VALUE; i < pushCounter; i++) {
+        if (overrunIndex < overrunData.size() && overrunData[overrunIndex] == i) {
+            overrunIndex++;
+        } else if (popIndex < popData.size() && popData[popIndex] == i) {
+            popIndex++;
+        } else {
+            std::cout << "data loss detected at index: " << i << std::endl;
+            dataIntact = false;
+            break;
+        }
+    }
+
+    CHECK(dataIntact);
+    CHECK(pushCounter == (overrunData.size() + popData.size()));
+}
+
+// the producer is throttled to stay at most 'distance' elements ahead of the consumer
+template <typename Layout>
+double benchmarkLayout(uint64_t distance) {
+    constexpr std::uint32_t ContainerCapacity {64};
+    constexpr uint64_t      NUMBER_OF_TRANSFERS {1000000};
+    using DataType = uint64_t;
+    using RoQueT   = RoQueT<DataType, ContainerCapacity, Layout>;
+
+    auto roquet   = std::make_unique<RoQueT>();
+    auto producer = roquet->producer();
+    auto consumer = roquet->consumer();
+
+    return benchmarkThrottledTransfer(
+        NUMBER_OF_TRANSFERS, distance, [&](DataType data) { producer.push(data); }, [&] { return consumer.pop().has_value(); });
+}
+
+TEST_CASE("RoQueT - Layout benchmark", "[!benchmark]") {
+    constexpr uint64_t ContainerCapacity {64};
+
+    std::cout << "distance \tpacked [ns] \tpadded [ns] \tinterleaved [ns]" << std::endl;
+    for (uint64_t distance = 0; distance <= ContainerCapacity; distance = distance == 0 ? 1 : distance * 2) {
+        std::cout << distance;
+        std::cout << " \t" << benchmarkLayout<PackedLayout>(distance);
+        std::cout << " \t" << benchmarkLayout<PaddedLayout>(distance);
+        std::cout << " \t" << benchmarkLayout<InterleavedLayout>(distance);
+        std::cout << std::endl;
+    }
+}
+
+// the packed layout with the scalar scan for the END candidate; everything but the scan is identical to the packed layout
+struct PackedScalarScanLayout : PackedLayout {
+    template <typename T>
+    struct DynamicStorage : PackedLayout::DynamicStorage<T> {
+        using PackedLayout::DynamicStorage<T>::DynamicStorage;
+        uint64_t find(uint64_t from, uint64_t to, uint8_t flags) const { return findStateScalar(*this, from, to, flags); }
+    };
+};
+
+template <typename Layout>
+double benchmarkOverflowRecovery(uint64_t capacity) {
+    constexpr uint64_t NUMBER_OF_REPETITIONS {10};
+    using DataType = uint64_t;
+    using RoQueT   = RoQueT<DataType, DYNAMIC_CAPACITY, Layout>;
+
+    auto memory = std::unique_ptr<void, decltype(&std::free)>(
+        std::aligned_alloc(RoQueT::memory_alignment(), alignUp(RoQueT::required_memory_size(capacity), RoQueT::memory_alignment())), &std::free);
+
+    std::chrono::nanoseconds recoveryTime {0};
+    for (uint64_t i = 0; i < NUMBER_OF_REPETITIONS; ++i) {
+        RoQueT roquet(capacity, memory.get());
+        auto   producer = roquet.producer();
+        auto   consumer = roquet.consumer();
+        consumer.set_wrap_around_budget(2);
+
+        // the END is half of the capacity ahead of the head position of the consumer
+        for (DataType data = 0; data < capacity + 1 + capacity / 2; ++data) {
+            producer.push(data);
+        }
+
+        auto startTime = std::chrono::high_resolution_clock::now();
+        auto popResult = consumer.pop_checked();
+        recoveryTime += std::chrono::high_resolution_clock::now() - startTime;
+        REQUIRE(popResult.status == PopStatus::OVERFLOW_RECOVERED);
+    }
+
+    return static_cast<double>(recoveryTime.count()) / NUMBER_OF_REPETITIONS;
+}
+
+TEST_CASE("RoQueT - Overflow recovery benchmark", "[!benchmark]") {
+    // both variants use the packed layout and the same search configuration and differ only in the SIMD or scalar scan of the states
+    std::cout << "capacity \tSIMD scan [ns] \tscalar scan [ns]" << std::endl;
+    for (uint64_t capacity = 1024; capacity <= (1ULL << 20); capacity *= 4) {
+        std::cout << capacity;
+        std::cout << " \t" << benchmarkOverflowRecovery<PackedLayout>(capacity);
+        std::cout << " \t" << benchmarkOverflowRecovery<PackedScalarScanLayout>(capacity);
+        std::cout << std::endl;
+    }
+}
@@ -0,0 +1,82 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// SPDX-FileCopyrightText: © 2023 Mathias Kraus <elboberido@m-hias.de>
+
+#include "shared_roquet.hpp"
+
+#include "catch.hpp"
+
+#include <string>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+SCENARIO("SharedRoQueT - Unittest") {
+    constexpr std::uint32_t ContainerCapacity {10};
+    using DataType     = size_t;
+    using SharedRoQueT = SharedRoQueT<DataType, ContainerCapacity>;
+
+    const std::string name {"/roquet_unittest_" + std::to_string(getpid())};
+
+    GIVEN("A SharedRoQueT created in a shared memory segment") {
+        auto created = SharedRoQueT::create(name);
+        REQUIRE(created.has_value() == true);
+
+        WHEN("creating the same segment again") {
+            THEN("it should fail") {
+                REQUIRE(SharedRoQueT::create(name).has_value() == false);
+            }
+        }
+
+        WHEN("opening the segment with a different capacity") {
+            THEN("it should fail") {
+                REQUIRE(::SharedRoQueT<DataType, ContainerCapacity + 1>::open(name).has_value() == false);
+            }
+        }
+
+        WHEN("opening the segment with a different data type") {
+            THEN("it should fail") {
+                REQUIRE(::SharedRoQueT<uint8_t, ContainerCapacity>::open(name).has_value() == false);
+            }
+        }
+
+        WHEN("a second process opens the segment and pushes data") {
+            constexpr DataType NumberOfPushes {5};
+
+            auto pid = fork();
+            REQUIRE(pid != -1);
+            if (pid == 0) {
+                auto opened = SharedRoQueT::open(name);
+                if (!opened.has_value()) { _exit(1); }
+                auto producer = opened->roquet().producer();
+                for (DataType i = 0; i < NumberOfPushes; ++i) {
+                    producer.push(i);
+                }
+                _exit(0);
+            }
+
+            int status {0};
+            waitpid(pid, &status, 0);
+
+            THEN("the first process should pop the data") {
+                REQUIRE(WIFEXITED(status));
+                REQUIRE(WEXITSTATUS(status) == 0);
+
+                auto consumer = created->roquet().consumer();
+                for (DataType i = 0; i < NumberOfPushes; ++i) {
+                    auto popReturnValue = consumer.pop();
+                    REQUIRE(popReturnValue.has_value() == true);
+                    REQUIRE(popReturnValue.value() == i);
+                }
+                REQUIRE(consumer.empty() == true);
+            }
+        }
+    }
+
+    GIVEN("No shared memory segment") {
+        WHEN("opening the segment") {
+            THEN("it should fail") {
+                REQUIRE(SharedRoQueT::open(name).has_value() == false);
+            }
+        }
+    }
+}
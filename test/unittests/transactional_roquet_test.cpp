@@ -0,0 +1,263 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// SPDX-FileCopyrightText: © 2023 Mathias Kraus <elboberido@m-hias.de>
+
+#include "shared_roquet.hpp"
+#include "transactional_roquet.hpp"
+
+#include "catch.hpp"
+
+#include <memory>
+#include <string>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+SCENARIO("TransactionalRoQueT - Unittest") {
+    constexpr std::uint32_t ContainerCapacity {10};
+    using DataType            = size_t;
+    using TransactionalRoQueT = TransactionalRoQueT<DataType, ContainerCapacity>;
+    using PushStep            = TransactionalRoQueT::PushStep;
+    using PopStep             = TransactionalRoQueT::PopStep;
+
+    // a crash at a specific step is simulated by writing the transaction record like the crashed operation would have done it
+    auto pushRecord = [](TransactionalRoQueT& roquet) -> auto& { return const_cast<TransactionalRoQueT::PushTransaction&>(roquet.pushTransactionRecord()); };
+    auto popRecord  = [](TransactionalRoQueT& roquet) -> auto& { return const_cast<TransactionalRoQueT::PopTransaction&>(roquet.popTransactionRecord()); };
+
+    GIVEN("A TransactionalRoQueT") {
+        auto roquet   = std::make_unique<TransactionalRoQueT>();
+        auto producer = roquet->producer();
+        auto consumer = roquet->consumer();
+
+        WHEN("the roquet was just created") {
+            THEN("it should be empty and there should be nothing to recover") {
+                REQUIRE(producer.empty() == true);
+                REQUIRE(consumer.empty() == true);
+                REQUIRE(producer.recover().has_value() == false);
+                REQUIRE(consumer.recover().has_value() == false);
+            }
+        }
+
+        WHEN("pushing more data than the capacity") {
+            constexpr DataType NumberOfPushes {ContainerCapacity + 3};
+            DataType           overflowCounter {0};
+            for (DataType i = 0; i < NumberOfPushes; ++i) {
+                auto pushReturnValue = producer.push(i);
+                if (pushReturnValue.has_value()) {
+                    REQUIRE(pushReturnValue.value() == overflowCounter);
+                    ++overflowCounter;
+                }
+            }
+
+            THEN("the data should be popped in order and the transactions should be idle") {
+                REQUIRE(overflowCounter == 2);
+                for (DataType i = overflowCounter; i < NumberOfPushes; ++i) {
+                    auto popReturnValue = consumer.pop();
+                    REQUIRE(popReturnValue.has_value() == true);
+                    REQUIRE(popReturnValue.value() == i);
+                }
+                REQUIRE(consumer.empty() == true);
+                REQUIRE(roquet->pushTransactionRecord().step.load() == PushStep::IDLE);
+                REQUIRE(roquet->popTransactionRecord().step.load() == PopStep::IDLE);
+            }
+        }
+
+        WHEN("overflowing the queue with the transactional producer") {
+            constexpr DataType NumberOfPushes {ContainerCapacity + 3};
+            DataType           overflowCounter {0};
+            for (DataType i = 0; i < NumberOfPushes; ++i) {
+                if (producer.push(i).has_value()) { ++overflowCounter; }
+            }
+
+            THEN("the first pop should report the number of lost elements and the following pops plain data") {
+                REQUIRE(overflowCounter == 2);
+                auto popResult = consumer.pop_checked();
+                REQUIRE(popResult.status == PopStatus::OVERFLOW_RECOVERED);
+                REQUIRE(popResult.lost == overflowCounter);
+                REQUIRE(popResult.data.value() == overflowCounter);
+                for (DataType i = overflowCounter + 1; i < NumberOfPushes; ++i) {
+                    popResult = consumer.pop_checked();
+                    REQUIRE(popResult.status == PopStatus::DATA);
+                    REQUIRE(popResult.data.value() == i);
+                }
+                REQUIRE(consumer.pop_checked().status == PopStatus::EMPTY);
+            }
+
+            AND_WHEN("overflowing the queue again") {
+                while (consumer.pop().has_value()) {}
+                DataType secondOverflowCounter {0};
+                for (DataType i = NumberOfPushes; i < 2 * NumberOfPushes; ++i) {
+                    if (producer.push(i).has_value()) { ++secondOverflowCounter; }
+                }
+
+                THEN("only the elements lost since the last report should be reported") {
+                    auto popResult = consumer.pop_checked();
+                    REQUIRE(popResult.status == PopStatus::OVERFLOW_RECOVERED);
+                    REQUIRE(secondOverflowCounter == 2);
+                    REQUIRE(popResult.lost == secondOverflowCounter);
+                    REQUIRE(popResult.data.value() == NumberOfPushes + secondOverflowCounter);
+                }
+            }
+        }
+
+        WHEN("reattaching the producer and consumer") {
+            producer.push(1);
+            producer.push(2);
+            consumer.pop();
+            auto newProducer = roquet->producer();
+            auto newConsumer = roquet->consumer();
+            newProducer.push(3);
+
+            THEN("they should continue at the persisted positions") {
+                REQUIRE(newConsumer.pop().value() == 2);
+                REQUIRE(newConsumer.pop().value() == 3);
+                REQUIRE(newConsumer.empty() == true);
+            }
+        }
+
+        WHEN("the producer crashed after starting a push but before advancing the END flag") {
+            constexpr DataType DATA {42};
+            auto&              record = pushRecord(*roquet);
+            record.data               = DATA;
+            record.position           = record.tailPosition.load();
+            record.replacedState.store(TransactionalRoQueT::Queue::DATA);
+            record.step.store(PushStep::ADVANCE_END);
+
+            auto recovered = roquet->producer().recover();
+
+            THEN("the recovery should finish the push") {
+                REQUIRE(recovered.has_value() == false);
+                REQUIRE(record.step.load() == PushStep::IDLE);
+                REQUIRE(consumer.pop().value() == DATA);
+                REQUIRE(consumer.empty() == true);
+            }
+        }
+
+        WHEN("the producer crashed before advancing the END flag of a full queue") {
+            for (DataType i = 0; i <= ContainerCapacity; ++i) {
+                producer.push(i);
+            }
+            constexpr DataType DATA {42};
+            auto&              record = pushRecord(*roquet);
+            record.data               = DATA;
+            record.position           = record.tailPosition.load();
+            record.replacedState.store(TransactionalRoQueT::Queue::DATA);
+            record.step.store(PushStep::ADVANCE_END);
+
+            auto recovered = roquet->producer().recover();
+
+            THEN("the recovery should return the overflowed data") {
+                REQUIRE(recovered.has_value() == true);
+                REQUIRE(recovered.value() == 0);
+                for (DataType i = 1; i <= ContainerCapacity; ++i) {
+                    REQUIRE(consumer.pop().value() == i);
+                }
+                REQUIRE(consumer.pop().value() == DATA);
+                REQUIRE(consumer.empty() == true);
+            }
+        }
+
+        WHEN("the producer crashed after publishing the data but before finishing the transaction") {
+            constexpr DataType DATA {42};
+            producer.push(DATA);
+            auto& record = pushRecord(*roquet);
+            record.tailPosition.store(record.position);
+            record.step.store(PushStep::PUBLISH_DATA);
+
+            auto recovered = roquet->producer().recover();
+
+            THEN("the recovery should not push the data a second time") {
+                REQUIRE(recovered.has_value() == false);
+                REQUIRE(consumer.pop().value() == DATA);
+                REQUIRE(consumer.empty() == true);
+                producer.push(DATA + 1);
+                REQUIRE(consumer.pop().value() == DATA + 1);
+            }
+        }
+
+        WHEN("the consumer crashed before claiming the data") {
+            constexpr DataType DATA {42};
+            producer.push(DATA);
+            auto& record    = popRecord(*roquet);
+            record.data     = DATA;
+            record.position = record.headPosition.load() + 1;
+            record.step.store(PopStep::CLAIMING);
+
+            auto recovered = roquet->consumer().recover();
+
+            THEN("the recovery should roll back the pop") {
+                REQUIRE(recovered.has_value() == false);
+                REQUIRE(record.step.load() == PopStep::IDLE);
+                REQUIRE(consumer.pop().value() == DATA);
+                REQUIRE(consumer.empty() == true);
+            }
+        }
+
+        WHEN("the consumer crashed after claiming the data but before persisting the head position") {
+            constexpr DataType DATA {42};
+            producer.push(DATA);
+            producer.push(DATA + 1);
+            consumer.pop();
+            auto& record = popRecord(*roquet);
+            record.headPosition.store(record.position - 1);
+            record.step.store(PopStep::CLAIMED);
+
+            auto recovered = roquet->consumer().recover();
+
+            THEN("the recovery should return the claimed data and the next pop the following data") {
+                REQUIRE(recovered.has_value() == true);
+                REQUIRE(recovered.value() == DATA);
+                REQUIRE(consumer.pop().value() == DATA + 1);
+                REQUIRE(consumer.empty() == true);
+            }
+        }
+    }
+}
+
+SCENARIO("TransactionalRoQueT - Shared memory") {
+    constexpr std::uint32_t ContainerCapacity {10};
+    using DataType            = size_t;
+    using TransactionalRoQueT = TransactionalRoQueT<DataType, ContainerCapacity>;
+    using SharedRoQueT        = SharedRoQueT<DataType, ContainerCapacity, PackedLayout, TransactionalRoQueT>;
+
+    const std::string name {"/transactional_roquet_unittest_" + std::to_string(getpid())};
+
+    GIVEN("A TransactionalRoQueT in a shared memory segment") {
+        auto created = SharedRoQueT::create(name);
+        REQUIRE(created.has_value() == true);
+
+        WHEN("a producer process terminates and a restarted producer process continues") {
+            auto runProducer = [&](DataType first, DataType last) {
+                auto pid = fork();
+                REQUIRE(pid != -1);
+                if (pid == 0) {
+                    auto opened = SharedRoQueT::open(name);
+                    if (!opened.has_value()) { _exit(1); }
+                    auto producer = opened->roquet().producer();
+                    producer.recover();
+                    for (DataType i = first; i < last; ++i) {
+                        producer.push(i);
+                    }
+                    _exit(0);
+                }
+
+                int status {0};
+                waitpid(pid, &status, 0);
+                REQUIRE(WIFEXITED(status));
+                REQUIRE(WEXITSTATUS(status) == 0);
+            };
+
+            runProducer(0, 3);
+            runProducer(3, 6);
+
+            THEN("the consumer should pop the data of both processes in order") {
+                auto consumer = created->roquet().consumer();
+                for (DataType i = 0; i < 6; ++i) {
+                    auto popReturnValue = consumer.pop();
+                    REQUIRE(popReturnValue.has_value() == true);
+                    REQUIRE(popReturnValue.value() == i);
+                }
+                REQUIRE(consumer.empty() == true);
+            }
+        }
+    }
+}
@@ -0,0 +1,243 @@
+// SPDX-License-Identifier: GPL-3.0-only
+// SPDX-FileCopyrightText: © 2023 Mathias Kraus <elboberido@m-hias.de>
+
+#include "roquet.hpp"
+#include "wait_free_roquet.hpp"
+
+#include "catch.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+SCENARIO("WaitFreeRoQueT - Unittest") {
+    constexpr std::uint32_t ContainerCapacity {10};
+    using DataType       = size_t;
+    using WaitFreeRoQueT = WaitFreeRoQueT<DataType, ContainerCapacity>;
+
+    GIVEN("A WaitFreeRoQueT with a fixed capacity") {
+        auto roquet   = std::make_unique<WaitFreeRoQueT>();
+        auto producer = roquet->producer();
+        auto consumer = roquet->consumer();
+
+        WHEN("the roquet was just created") {
+            THEN("it should be empty") {
+                REQUIRE(producer.empty() == true);
+                REQUIRE(consumer.empty() == true);
+                REQUIRE(consumer.pop().has_value() == false);
+            }
+        }
+
+        WHEN("pushing data up to the capacity") {
+            for (DataType i = 0; i <= ContainerCapacity; ++i) {
+                REQUIRE(producer.push(i).has_value() == false);
+            }
+
+            THEN("the data should be popped in order") {
+                for (DataType i = 0; i <= ContainerCapacity; ++i) {
+                    auto popReturnValue = consumer.pop();
+                    REQUIRE(popReturnValue.has_value() == true);
+                    REQUIRE(popReturnValue.value() == i);
+                }
+                REQUIRE(consumer.empty() == true);
+                REQUIRE(consumer.pop().has_value() == false);
+            }
+        }
+
+        WHEN("overflowing the roquet once") {
+            for (DataType i = 0; i <= ContainerCapacity + 1; ++i) {
+                REQUIRE(producer.push(i).has_value() == false);
+            }
+
+            THEN("the overflowed data should be parked and popped first") {
+                for (DataType i = 0; i <= ContainerCapacity + 1; ++i) {
+                    auto popReturnValue = consumer.pop();
+                    REQUIRE(popReturnValue.has_value() == true);
+                    REQUIRE(popReturnValue.value() == i);
+                }
+                REQUIRE(consumer.pop().has_value() == false);
+            }
+        }
+
+        WHEN("overflowing the roquet twice") {
+            for (DataType i = 0; i <= ContainerCapacity + 1; ++i) {
+                REQUIRE(producer.push(i).has_value() == false);
+            }
+            auto pushReturnValue = producer.push(ContainerCapacity + 2);
+
+            THEN("the previously parked data should be returned and the consumer should continue with the newly parked data") {
+                REQUIRE(pushReturnValue.has_value() == true);
+                REQUIRE(pushReturnValue.value() == 0);
+                for (DataType i = 1; i <= ContainerCapacity + 2; ++i) {
+                    auto popReturnValue = consumer.pop();
+                    REQUIRE(popReturnValue.has_value() == true);
+                    REQUIRE(popReturnValue.value() == i);
+                }
+                REQUIRE(consumer.pop().has_value() == false);
+            }
+        }
+
+        WHEN("the consumer took the parked data") {
+            for (DataType i = 0; i <= ContainerCapacity + 1; ++i) {
+                producer.push(i);
+            }
+            auto popReturnValue = consumer.pop();
+            REQUIRE(popReturnValue.value() == 0);
+
+            THEN("the next overflows should not return it again") {
+                REQUIRE(producer.push(ContainerCapacity + 2).has_value() == false);
+                auto pushReturnValue = producer.push(ContainerCapacity + 3);
+                REQUIRE(pushReturnValue.has_value() == true);
+                REQUIRE(pushReturnValue.value() == 1);
+            }
+        }
+
+        WHEN("overflowing the roquet multiple times") {
+            constexpr DataType NumberOfPushes {5 * ContainerCapacity + 3};
+            std::vector<DataType> overflowData;
+            for (DataType i = 0; i < NumberOfPushes; ++i) {
+                auto pushReturnValue = producer.push(i);
+                if (pushReturnValue.has_value()) { overflowData.push_back(pushReturnValue.value()); }
+            }
+
+            THEN("each data should either be returned by push or by pop") {
+                std::vector<DataType> popData;
+                while (auto popReturnValue = consumer.pop()) {
+                    popData.push_back(popReturnValue.value());
+                }
+                REQUIRE(popData.size() == ContainerCapacity + 2);
+                REQUIRE(overflowData.size() + popData.size() == NumberOfPushes);
+                for (DataType i = 0; i < overflowData.size(); ++i) {
+                    REQUIRE(overflowData[i] == i);
+                }
+                for (DataType i = 0; i < popData.size(); ++i) {
+                    REQUIRE(popData[i] == overflowData.size() + i);
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("WaitFreeRoQueT - Stress", "[.stress]") {
+    constexpr std::uint32_t ContainerCapacity {10};
+    using DataType       = uint64_t;
+    using WaitFreeRoQueT = WaitFreeRoQueT<DataType, ContainerCapacity>;
+
+    constexpr uint64_t NUMBER_OF_PUSHES {1000000};
+
+    std::atomic<bool> pushThreadFinished {false};
+
+    auto roquet   = std::make_unique<WaitFreeRoQueT>();
+    auto producer = roquet->producer();
+    auto consumer = roquet->consumer();
+
+    std::vector<DataType> overrunData;
+    std::vector<DataType> popData;
+    overrunData.reserve(NUMBER_OF_PUSHES);
+    popData.reserve(NUMBER_OF_PUSHES);
+
+    auto pushThread = std::thread([&] {
+        for (DataType i = 0; i < NUMBER_OF_PUSHES; ++i) {
+            auto retVal = producer.push(i);
+            if (retVal.has_value()) { overrunData.push_back(retVal.value()); }
+        }
+        pushThreadFinished = true;
+    });
+
+    auto popThread = std::thread([&] {
+        while (!pushThreadFinished.load() || !consumer.empty()) {
+            auto retVal = consumer.pop();
+            if (retVal.has_value()) { popData.push_back(retVal.value()); }
+        }
+    });
+
+    pushThread.join();
+    popThread.join();
+
+    std::cout << "wait-free overrun counter \t" << overrunData.size() << std::endl;
+    std::cout << "wait-free pop counter \t" << popData.size() << std::endl;
+
+    CHECK(std::is_sorted(overrunData.begin(), overrunData.end()));
+    CHECK(std::adjacent_find(popData.begin(), popData.end(), [](auto lhs, auto rhs) { return lhs >= rhs; }) == popData.end());
+
+    size_t overrunIndex = 0;
+    size_t popIndex     = 0;
+    bool   dataIntact   = true;
+    for (DataType i = 0; i < NUMBER_OF_PUSHES; i++) {
+        if (overrunIndex < overrunData.size() && overrunData[overrunIndex] == i) {
+            overrunIndex++;
+        } else if (popIndex < popData.size() && popData[popIndex] == i) {
+            popIndex++;
+        } else {
+            std::cout << "data loss detected at index: " << i << std::endl;
+            dataIntact = false;
+            break;
+        }
+    }
+
+    CHECK(dataIntact);
+    CHECK(NUMBER_OF_PUSHES == overrunData.size() + popData.size());
+}
+
+// the producer pushes without throttling and the consumer measures the duration of each pop while the queue overflows
+template <typename Queue>
+std::vector<int64_t> benchmarkPopLatency() {
+    constexpr uint64_t NUMBER_OF_PUSHES {2000000};
+
+    auto roquet   = std::make_unique<Queue>();
+    auto producer = roquet->producer();
+    auto consumer = roquet->consumer();
+
+    std::atomic<bool>    pushThreadFinished {false};
+    std::vector<int64_t> latencies;
+    latencies.reserve(NUMBER_OF_PUSHES);
+
+    auto pushThread = std::thread([&] {
+        for (uint64_t i = 0; i < NUMBER_OF_PUSHES; ++i) {
+            producer.push(i);
+        }
+        pushThreadFinished = true;
+    });
+
+    auto popThread = std::thread([&] {
+        while (!pushThreadFinished.load(std::memory_order_relaxed)) {
+            auto startTime = std::chrono::steady_clock::now();
+            auto retVal    = consumer.pop();
+            auto duration  = std::chrono::steady_clock::now() - startTime;
+            if (retVal.has_value()) {
+                latencies.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    pushThread.join();
+    popThread.join();
+
+    std::sort(latencies.begin(), latencies.end());
+    return latencies;
+}
+
+TEST_CASE("WaitFreeRoQueT - Pop latency benchmark under overflow", "[!benchmark]") {
+    constexpr uint64_t ContainerCapacity {64};
+    using DataType = uint64_t;
+
+    auto roquetLatencies   = benchmarkPopLatency<RoQueT<DataType, ContainerCapacity>>();
+    auto waitFreeLatencies = benchmarkPopLatency<WaitFreeRoQueT<DataType, ContainerCapacity>>();
+
+    auto percentile = [](const std::vector<int64_t>& latencies, double p) {
+        if (latencies.empty()) { return int64_t {0}; }
+        return latencies[static_cast<size_t>(p * static_cast<double>(latencies.size() - 1))];
+    };
+
+    std::cout << "percentile \tRoQueT [ns] \tWaitFreeRoQueT [ns]" << std::endl;
+    for (auto p : {0.5, 0.9, 0.99, 0.999, 0.9999, 1.0}) {
+        std::cout << p * 100 << "% \t" << percentile(roquetLatencies, p) << " \t" << percentile(waitFreeLatencies, p) << std::endl;
+    }
+    std::cout << "pops \t" << roquetLatencies.size() << " \t" << waitFreeLatencies.size() << std::endl;
+}